@@ -2,10 +2,22 @@
 #define TIKTAKTOE_AI_H
 
 
+#include <functional>
+#include <memory>
 #include <optional>
 #include <random>
+#include <utility>
+#include <vector>
 
+#include "CandidateScratch.h"
+#include "EndgameSolver.h"
 #include "GameState.h"
+#include "OpeningBook.h"
+#include "PnSolver.h"
+#include "SearchArena.h"
+#include "SearchLimits.h"
+#include "SearchStats.h"
+#include "Tablebase.h"
 
 namespace engine {
 
@@ -22,18 +34,103 @@ namespace engine {
 
             bool enableTwoPly = true;
 
-            bool enablePerfectClassic3x3 = true;
+            // Perfect play via df-pn on small finite classic boards (3x3, 4x4, 5x5 ...).
+            bool enableClassicSolver = true;
 
             unsigned seed = 0;
+
+            // 4x4 fits the node budget; 5x5 (N=4 needs ~20M nodes from the empty board) would burn it on every move.
+            int classicSolverMaxCells = 16;
+
+            std::uint64_t classicSolverNodes = 1'000'000;
+
+            // Exact alpha-beta to the end of the game once at most endgameMaxEmpties cells are empty (finite boards;
+            // a move limit makes the search shallower, not narrower). A timed-out search is used only if at least
+            // half of the root moves finished; otherwise the heuristic plays.
+            bool enableEndgameSolver = true;
+
+            int endgameMaxEmpties = 14;
+
+            int endgameTimeMs = 1000;
+
+            // Root candidates only on the 4 lines through stones, ranked by threat; the reach widens from
+            // candidateRadius to N-1 in quiet positions. Off = full square of candidateRadius, nearest first.
+            bool lineCandidates = true;
+
+            // Deprecated: old name of enableClassicSolver, from when only 3x3 was solved; false still turns the
+            // solver off. Not [[deprecated]]: GCC would warn in every implicit copy of Settings.
+            bool enablePerfectClassic3x3 = true;
+        };
+
+        // First-ply view of one cell for one player (see scoreCell).
+        struct CellScore {
+            bool legal = false;
+            long long move = 0;     // heuristic score of playing there
+            long long own = 0;      // line potential of the player at the cell
+            long long opponent = 0; // line potential of the opponent at the cell
         };
 
-        explicit SimpleAI(Settings s = {});
+        // One root move of an analysis, as the search compared it.
+        struct AnalysedMove {
+            Coord move{};
+            long long score = 0;    // what chooseMove ranks by: first ply minus the weighted best reply (plus noise)
+            long long firstPly = 0;
+            std::vector<Coord> pv;  // principal variation: the move, then the opponent's best reply if searched
+        };
+
+        SimpleAI();
+        explicit SimpleAI(Settings s);
 
         std::optional<Coord> chooseMove(const GameState& state, Player aiPlayer);
 
+        // Anytime variant: once the deadline, the node budget (move evaluations plus solver nodes) or the stop flag
+        // is hit, returns the best move found so far (always a legal move if one exists). Legal seeds (e.g. answers
+        // found while pondering) are scored before all other candidates.
+        std::optional<Coord> chooseMove(const GameState& state, Player aiPlayer, const SearchLimits& limits,
+                                        const std::vector<Coord>& seeds = {});
+
+        // Multi-PV: the best `count` root moves of one chooseMove search with their scores and lines, best first;
+        // the first is the move chooseMove would play. Moves from the tablebase, book or solvers come alone.
+        std::vector<AnalysedMove> analyse(const GameState& state, Player aiPlayer, std::size_t count,
+                                          const SearchLimits& limits = {});
+
+        // Up to count legal moves of p ranked by the first-ply heuristic alone, best first (e.g. likely replies
+        // of the opponent to ponder on). Does not touch lastStats().
+        std::vector<Coord> rankMoves(const GameState& state, Player p, std::size_t count);
+
+        // The first-ply heuristic at c for p, without the pull towards the last move, so the value only changes
+        // when a stone lands on one of the lines through c (or p's score/budget changes). Thread-safe.
+        CellScore scoreCell(const GameState& state, Player p, Coord c) const;
+
+        // Probed before any search when its rules fingerprint matches the game.
+        void setTablebase(std::shared_ptr<const Tablebase> tb) { tablebase_ = std::move(tb); }
+
+        // Probed right after the tablebase; positions outside the book or its rules fall through to the search.
+        void setOpeningBook(std::shared_ptr<const OpeningBook> book) { book_ = std::move(book); }
+
+        // Statistics of the last chooseMove call; the callback (if set) receives them as each call finishes.
+        const SearchStats& lastStats() const noexcept { return stats_; }
+
+        // Scratch memory of the heuristic search; spilled() > 0 means the last decision outgrew the buffer.
+        const SearchArena& arena() const noexcept { return arena_; }
+        void setStatsCallback(std::function<void(const SearchStats&)> cb) { onStats_ = std::move(cb); }
+
+        // Called on the searching thread as chooseMove moves through its stages and plies; keep it cheap.
+        void setProgressCallback(std::function<void(const SearchProgress&)> cb) { onProgress_ = std::move(cb); }
+
     private:
         Settings s_;
         std::mt19937 rng_;
+        PnSolver solver_;
+        EndgameSolver endgame_;
+        std::shared_ptr<const Tablebase> tablebase_;
+        std::shared_ptr<const OpeningBook> book_;
+        SearchStats stats_;
+        std::function<void(const SearchStats&)> onStats_;
+        std::function<void(const SearchProgress&)> onProgress_;
+        CandidateScratch scratch_;
+        SearchArena arena_;
+        std::vector<AnalysedMove>* lines_ = nullptr; // set by analyse(): every compared root move lands here
     };
 
 } // namespace engine
@@ -2,6 +2,7 @@
 #define TIKTAKTOE_BOARD_H
 #pragma once
 
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -25,6 +26,9 @@ namespace engine {
 
         virtual std::vector<std::pair<Coord, Player>> occupied() const = 0;
 
+        // Independent copy with the same stones.
+        virtual std::unique_ptr<IBoard> clone() const = 0;
+
         bool isEmpty(Coord c) const { return get(c) == Player::None; }
     };
 
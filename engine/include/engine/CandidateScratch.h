@@ -0,0 +1,69 @@
+#ifndef TIKTAKTOE_CANDIDATESCRATCH_H
+#define TIKTAKTOE_CANDIDATESCRATCH_H
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Board.h"
+
+namespace engine {
+
+    // Reusable buffers for candidate generation: a generation-stamped cell set (dense over a bounding box,
+    // 16x16 tiles outside it) and a bucket sort by Manhattan distance. Nothing is allocated once warmed up.
+    // Not thread-safe; copies start empty.
+    class CandidateScratch {
+    public:
+        CandidateScratch() = default;
+        CandidateScratch(const CandidateScratch&) {}
+        CandidateScratch& operator=(const CandidateScratch&) { return *this; }
+
+        // Starts a new, empty set. Cells in [lo, hi] use the dense array (if the box is not too large).
+        void beginMarks(Coord lo, Coord hi);
+        void beginMarks() { beginMarks(Coord{1, 1}, Coord{0, 0}); }
+
+        // True if c was not marked since beginMarks.
+        bool mark(Coord c);
+
+        // Orders the first `keep` cells (0 = all) nearest to ref first, ties by y then x; returns how many were kept.
+        std::size_t sortByDistance(std::span<Coord> cells, Coord ref, std::size_t keep);
+
+        // Empty cells within `radius` (Chebyshev) of the stones, ordered and truncated as sortByDistance.
+        // The view stays valid until the next call.
+        std::span<const Coord> neighborhood(const IBoard& board, const std::vector<std::pair<Coord, Player>>& stones,
+                                            int radius, Coord ref, std::size_t maxCandidates);
+
+    private:
+        static constexpr int kTileBits = 4;
+        static constexpr int kTileSide = 1 << kTileBits;
+        static constexpr std::size_t kMaxDense = std::size_t{1} << 20;
+
+        using Tile = std::array<std::uint32_t, kTileSide * kTileSide>;
+
+        std::uint32_t gen_ = 0;
+
+        std::vector<std::uint32_t> dense_;
+        Coord lo_{};
+        int denseW_ = 0;
+        int denseH_ = 0;
+
+        std::vector<Tile> tiles_;
+        std::unordered_map<std::uint64_t, std::uint32_t> tileIndex_;
+        std::uint64_t lastTileKey_ = 0;
+        std::uint32_t lastTile_ = 0;
+
+        std::vector<std::uint32_t> bucketStart_;
+        std::vector<Coord> sorted_;
+        std::vector<Coord> cells_;
+
+        std::uint32_t& tileStamp(Coord c);
+    };
+
+}
+
+#endif
@@ -0,0 +1,40 @@
+#ifndef TIKTAKTOE_CHANGEFEED_H
+#define TIKTAKTOE_CHANGEFEED_H
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+#include "Coord.h"
+#include "Player.h"
+
+namespace engine {
+
+    // One cell whose stone changed: set when `player` is X/O, cleared when it is None.
+    struct CellChange {
+        Coord coord{};
+        Player player = Player::None;   // stone on the cell now
+        Player previous = Player::None; // stone before the change
+
+        bool set() const noexcept { return player != Player::None; }
+    };
+
+    // Everything one GameState operation changed (a move, undo, redo, seek or new game), published at once.
+    struct ChangeBatch {
+        std::uint64_t seq = 0; // +1 per operation of the GameState; a gap means a batch was missed
+
+        // newGame or assignment replaced the whole position: drop everything, `cells` lists the stones of the new
+        // position (previous = None).
+        bool reset = false;
+
+        std::vector<CellChange> cells; // in the order they were applied
+        bool statsChanged = false;     // score, lines or budget of either side
+        bool resultChanged = false;    // result or end reason
+    };
+
+    using ChangeListener = std::function<void(const ChangeBatch&)>;
+
+} // namespace engine
+
+#endif
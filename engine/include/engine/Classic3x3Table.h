@@ -0,0 +1,23 @@
+#ifndef TIKTAKTOE_CLASSIC3X3TABLE_H
+#define TIKTAKTOE_CLASSIC3X3TABLE_H
+#pragma once
+
+#include <cstdint>
+
+namespace engine {
+
+    // Perfect-play table for classic 3x3 (N=3), generated at compile time.
+    // Position index: sum of cell(i) * 3^i, i = y*3 + x, cell 0 = empty, 1 = X, 2 = O.
+    // The side to move is implied by stone counts (X moves first).
+    struct Classic3x3Entry {
+        std::int8_t score = 0;   // for the side to move: >0 win, 0 draw, <0 loss; faster wins score higher
+        std::uint8_t move = 9;   // best cell index 0..8, 9 = none (terminal or unreachable)
+    };
+
+    inline constexpr int kClassic3x3Positions = 19683; // 3^9
+
+    const Classic3x3Entry& classic3x3Lookup(int index) noexcept;
+
+}
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef TIKTAKTOE_ENDGAMESOLVER_H
+#define TIKTAKTOE_ENDGAMESOLVER_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "GameState.h"
+#include "SearchLimits.h"
+
+namespace engine {
+
+    // Exact alpha-beta search to the end of the game on a finite board. The value is the final margin for the side
+    // to move: linesDiff * linesScale + scoreDiff (lines count only with maximizeLines), or +-(kWinValue + empties)
+    // when a classic line / target score ends the game. Root moves are searched in parallel with a shared alpha;
+    // nodes whose value ScoreBounds already pins outside the window (or to one value) are not expanded.
+    class EndgameSolver {
+    public:
+        static constexpr long long kWinValue = 1LL << 60;
+
+        struct Settings {
+            std::size_t tableEntries = std::size_t{1} << 20; // shared between threads, rounded up to a power of two
+
+            unsigned threads = 0; // 0 = hardware concurrency
+        };
+
+        struct Result {
+            std::optional<Coord> move;
+            long long value = 0;     // for aiPlayer, exact only if `exact`
+            bool exact = false;      // all root moves finished within the limits
+            std::size_t rootsFinished = 0;
+            std::size_t rootsTotal = 0; // after symmetric duplicates are dropped
+            std::uint64_t nodes = 0;
+            std::uint64_t tableProbes = 0;
+            std::uint64_t tableHits = 0;
+        };
+
+        EndgameSolver();
+        explicit EndgameSolver(Settings s);
+
+        // Finite board, at most 255 cells, no budget-limited move costs, margins fit into 64 bits.
+        static bool supports(const RuleSet& rules, const IBoard& board);
+
+        // Moves left until the game ends by board-full / move limit.
+        static int remainingMoves(const GameState& state);
+
+        // Empty cells of a finite board: the branching factor at the root, whatever the move limit.
+        static int emptyCells(const GameState& state);
+
+        // Best move for aiPlayer (must be the side to move). When a limit is hit returns the best fully searched
+        // root move, or no move if none finished.
+        Result solve(const GameState& state, Player aiPlayer, const SearchLimits& limits);
+
+    private:
+        struct Entry {
+            std::uint64_t key = 0;
+            long long value = 0;
+            std::uint8_t bound = 0; // 0 = empty, 1 = exact, 2 = lower, 3 = upper
+            std::uint8_t best = 0xff;
+        };
+
+        struct Context;
+        class Worker;
+
+        Settings s_;
+        std::vector<Entry> table_;          // one segment per thread
+        std::uint64_t tableRules_ = 0;      // fingerprint the cached values belong to
+    };
+
+}
+
+#endif
@@ -22,6 +22,7 @@ namespace engine {
         bool clear(Coord c) override;
 
         std::vector<std::pair<Coord, Player>> occupied() const override;
+        std::unique_ptr<IBoard> clone() const override;
 
     private:
         int width_ = 0;
@@ -0,0 +1,59 @@
+#ifndef TIKTAKTOE_FRONTIERMAPS_H
+#define TIKTAKTOE_FRONTIERMAPS_H
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+
+#include "Board.h"
+#include "LinePatterns.h"
+#include "RuleSet.h"
+#include "Scoring.h"
+
+namespace engine {
+
+    // What a move at an empty cell would give one player.
+    struct CellEval {
+        MoveDelta delta{};
+        LinePotential potential{};
+    };
+
+    struct FrontierCell {
+        CellEval eval[2]{}; // by playerIndex
+
+        const CellEval& of(Player p) const noexcept { return eval[p == Player::O ? 1 : 0]; }
+    };
+
+    // Move deltas and line potentials of every frontier cell (empty, within `radius` of a stone, Chebyshev),
+    // kept up to date stone by stone: a stone only changes cells on the 4 lines through it, up to the first
+    // empty cell past a single-colour run, plus frontier membership in its radius box.
+    class FrontierMaps {
+    public:
+        using Cells = std::unordered_map<Coord, FrontierCell, CoordHash>;
+
+        int radius() const noexcept { return radius_; }
+        bool enabled() const noexcept { return radius_ > 0; }
+
+        // radius <= 0 disables tracking.
+        void reset(int radius);
+        void rebuild(const IBoard& board, const RuleSet& rules, const LinePatterns& patterns);
+
+        // Board already contains / no longer contains the stone at c.
+        void onPlaced(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns);
+        void onRemoved(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns);
+
+        const Cells& cells() const noexcept { return cells_; }
+        const FrontierCell* find(Coord c) const;
+
+    private:
+        int radius_ = 0;
+        Cells cells_;
+        std::unordered_map<Coord, int, CoordHash> near_; // stones within radius (the cell itself included)
+
+        void compute(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns, FrontierCell& out) const;
+        void refreshLines(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns);
+    };
+
+}
+
+#endif
@@ -2,14 +2,21 @@
 #define TIKTAKTOE_GAMESTATE_H
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <optional>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Board.h"
+#include "CandidateScratch.h"
+#include "ChangeFeed.h"
+#include "FrontierMaps.h"
+#include "LinePatterns.h"
 #include "Move.h"
 #include "RuleSet.h"
+#include "Symmetry.h"
 
 namespace engine {
 
@@ -32,11 +39,25 @@ public:
     GameState();
     GameState(RuleSet rules, std::unique_ptr<IBoard> board);
 
+    // Deep copy (board cloned, history included): a snapshot another thread can search while this one plays on.
+    // Listeners are not copied; assignment keeps the target's listeners and publishes a reset to them.
+    GameState(const GameState& other);
+    GameState& operator=(const GameState& other);
+    GameState(GameState&&) = default;
+    GameState& operator=(GameState&&) = default;
+
     void newGame(RuleSet rules, std::unique_ptr<IBoard> board);
 
     static std::unique_ptr<IBoard> createBoard(const RuleSet& rules);
 
     const RuleSet& rules() const noexcept { return rules_; }
+    const LinePatterns& linePatterns() const noexcept { return patterns_; }
+    const BoardSymmetry& symmetry() const noexcept { return symmetry_; } // detected in newGame
+
+    // Per-cell move deltas / potentials of the frontier, patched by every move, undo and redo.
+    // Stones placed through the mutable board() bypass it; call setFrontierRadius() to rebuild.
+    const FrontierMaps& frontier() const noexcept { return frontier_; }
+    void setFrontierRadius(int radius); // <= 0 disables tracking
     const IBoard& board() const noexcept { return *board_; }
     IBoard& board() noexcept { return *board_; }
 
@@ -55,17 +76,31 @@ public:
     int lastMoveCost() const noexcept { return lastMoveCost_; }
 
     MoveOutcome tryMakeMove(Coord c);
+    // Plays the moves in order up to the first illegal one as one operation (one batch); returns how many were played.
+    std::size_t playMoves(const std::vector<Coord>& moves);
 
     bool canUndo() const noexcept { return !undoStack_.empty(); }
     bool canRedo() const noexcept { return !redoStack_.empty(); }
     bool undo();
     bool redo();
 
+    // Undoes or redoes moves until moveCount() == target (clamped to the history); one batch for the whole jump.
+    bool seek(int targetMoveCount);
+
+    // Change feed: every operation above and newGame publishes one ChangeBatch to the listeners, synchronously and
+    // after the state is consistent. Stones placed through the mutable board() are not reported.
+    int subscribe(ChangeListener listener);
+    void unsubscribe(int id);
+    std::uint64_t changeSeq() const noexcept { return changeSeq_; } // seq of the last published batch
+
     bool isMoveLegal(Coord c) const;
     int moveCost(Coord c) const;
     long long cellWeight(Coord c) const;
 
+    // Safe to call concurrently on one const GameState. The first form reuses a thread_local scratch; the second
+    // takes the caller's own, as SimpleAI keeps one per instance.
     std::vector<Coord> generateCandidateMoves(int radius, std::size_t maxCandidates) const;
+    std::vector<Coord> generateCandidateMoves(int radius, std::size_t maxCandidates, CandidateScratch& scratch) const;
 
 private:
     struct Snapshot {
@@ -87,6 +122,10 @@ private:
 
     RuleSet rules_{};
     std::unique_ptr<IBoard> board_{};
+    LinePatterns patterns_{}; // rebuilt in newGame when N changes
+    BoardSymmetry symmetry_{};
+    FrontierMaps frontier_{};
+    int frontierRadius_ = 2;
 
     Player current_ = Player::X;
     int moveCount_ = 0;
@@ -101,6 +140,17 @@ private:
     std::vector<MoveRecord> undoStack_;
     std::vector<MoveRecord> redoStack_;
 
+    std::vector<std::pair<int, ChangeListener>> listeners_;
+    int nextListenerId_ = 1;
+    std::uint64_t changeSeq_ = 0;
+    int changeDepth_ = 0;     // nested operations (seek -> undo) publish once, from the outermost
+    ChangeBatch pending_{};
+    Snapshot changeBefore_{}; // stats and result at the start of the outermost operation
+
+    void beginChanges();
+    void noteCell(Coord c, Player now, Player before);
+    void endChanges(bool reset = false);
+
     Snapshot makeSnapshot() const;
     void restoreSnapshot(const Snapshot& s);
 
@@ -22,6 +22,7 @@ namespace engine {
         bool clear(Coord c) override;
 
         std::vector<std::pair<Coord, Player>> occupied() const override;
+        std::unique_ptr<IBoard> clone() const override;
 
         std::size_t occupiedCount() const noexcept { return cells_.size(); }
 
@@ -0,0 +1,63 @@
+#ifndef TIKTAKTOE_LINEPATTERNS_H
+#define TIKTAKTOE_LINEPATTERNS_H
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Board.h"
+
+namespace engine {
+
+    // Line potential of an empty cell for one player: sum over the 4 directions of the value of the run
+    // the cell would join, plus the best (longest, then most open) of those runs.
+    struct LinePotential {
+        bool canWin = false;
+        int bestLen = 1;      // saturates above N
+        int bestOpenEnds = 0;
+        long long value = 0;
+    };
+
+    // Lookup tables for line potential, built once per N.
+    // Each side of a direction is read as a window of up to N cells, 2 bits per cell (empty / own / blocked);
+    // the window maps to (run length, open end), and the pair of sides maps to (length, open ends, value).
+    class LinePatterns {
+    public:
+        static constexpr int kMaxTableN = 8; // side tables have 4^N entries; longer lines are scanned directly
+
+        LinePatterns() = default;
+        explicit LinePatterns(int N);
+
+        int N() const noexcept { return N_; }
+
+        LinePotential potentialAt(const IBoard& board, Player p, Coord c) const;
+
+        // Value of a run of `len` stones with `openEnds` free ends (0..2).
+        static long long directionValue(int len, int openEnds, int N);
+
+    private:
+        struct Direction {
+            long long value = 0;
+            int len = 0;
+            std::uint8_t openEnds = 0;
+            bool canWin = false;
+        };
+
+        int N_ = 0;
+        int window_ = 0; // cells read on each side
+
+        std::vector<std::uint8_t> side_; // pattern -> run | (open << 7); empty when N > kMaxTableN
+        std::vector<Direction> dir_;     // [runL][runR][openL][openR]
+
+        struct Side {
+            int run = 0;
+            bool open = false;
+        };
+
+        Side readSide(const IBoard& board, Player p, Coord c, int dx, int dy) const;
+        Direction direction(Side left, Side right) const;
+    };
+
+}
+
+#endif
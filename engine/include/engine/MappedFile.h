@@ -0,0 +1,39 @@
+#ifndef TIKTAKTOE_MAPPEDFILE_H
+#define TIKTAKTOE_MAPPEDFILE_H
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace engine {
+
+    // Read-only memory map of a whole file. Move-only; unmaps on destruction.
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        bool open(const std::string& path);
+        void close() noexcept;
+
+        bool isOpen() const noexcept { return data_ != nullptr; }
+        const std::byte* data() const noexcept { return data_; }
+        std::size_t size() const noexcept { return size_; }
+
+    private:
+        const std::byte* data_ = nullptr;
+        std::size_t size_ = 0;
+#ifdef _WIN32
+        void* file_ = nullptr;
+        void* mapping_ = nullptr;
+#endif
+    };
+
+}
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef TIKTAKTOE_OPENINGBOOK_H
+#define TIKTAKTOE_OPENINGBOOK_H
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "GameState.h"
+#include "MappedFile.h"
+
+namespace engine {
+
+    // Opening moves for one rule set, built offline from self-play (tools/opening_book_gen) and probed through a
+    // memory map: the file is a header followed by entries sorted by key, so a lookup is one binary search.
+    //
+    // Key = canonical position hash (BoardSymmetry) with the side to move mixed in; the move is stored in the
+    // canonical frame, so one entry serves all symmetric variants of a position.
+    class OpeningBook {
+    public:
+        struct Header {
+            char magic[8]{};
+            std::uint32_t version = 0;
+            std::uint32_t maxPly = 0;          // no entries for positions with more stones
+            std::int32_t width = 0;            // 0 on an infinite board
+            std::int32_t height = 0;
+            std::uint64_t rulesFingerprint = 0;
+            std::uint64_t entryCount = 0;
+        };
+
+        struct Entry {
+            std::uint64_t key = 0;
+            std::int32_t x = 0;
+            std::int32_t y = 0;
+        };
+
+        // Key of the position and the transform that maps it onto its canonical frame.
+        static std::uint64_t positionKey(const GameState& state, int* transform = nullptr);
+
+        // Entry for `move` in `state`, move mapped into the canonical frame.
+        static Entry makeEntry(const GameState& state, Coord move);
+
+        // Sorts the entries (first one wins on equal keys) and writes the file. Returns false and fills error on failure.
+        static bool write(const RuleSet& rules, std::vector<Entry> entries, int maxPly, const std::string& path,
+                          std::string* error = nullptr);
+
+        bool open(const std::string& path);
+        void close() noexcept;
+
+        bool isOpen() const noexcept { return entries_ != nullptr; }
+        const Header& header() const noexcept { return header_; }
+
+        bool matches(const RuleSet& rules) const noexcept;
+
+        // Book move for the side to move, or nullopt if the position is not in the book (or the move is illegal).
+        std::optional<Coord> probe(const GameState& state) const;
+
+    private:
+        MappedFile file_;
+        Header header_{};
+        const Entry* entries_ = nullptr;
+    };
+
+}
+
+#endif
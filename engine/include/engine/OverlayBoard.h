@@ -0,0 +1,49 @@
+#ifndef TIKTAKTOE_OVERLAYBOARD_H
+#define TIKTAKTOE_OVERLAYBOARD_H
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+#include "Board.h"
+
+namespace engine {
+
+    // Read-through view of a board that keeps its own changes in a small local list, so a search can place
+    // and take back speculative stones without copying the base. The base must outlive the overlay and must not
+    // change while it is in use.
+    class OverlayBoard final : public IBoard {
+    public:
+        explicit OverlayBoard(const IBoard& base,
+                              std::pmr::memory_resource* mem = std::pmr::get_default_resource()) noexcept
+            : base_(&base), changes_(mem) {}
+
+        bool isFinite() const noexcept override { return base_->isFinite(); }
+        int width() const noexcept override { return base_->width(); }
+        int height() const noexcept override { return base_->height(); }
+        bool inBounds(Coord c) const noexcept override { return base_->inBounds(c); }
+
+        Player get(Coord c) const override;
+        bool set(Coord c, Player p) override;
+        bool clear(Coord c) override;
+
+        std::vector<std::pair<Coord, Player>> occupied() const override;
+        std::unique_ptr<IBoard> clone() const override; // flattened into a plain board, free of the base
+
+        const IBoard& base() const noexcept { return *base_; }
+        std::size_t changeCount() const noexcept { return changes_.size(); }
+        void reset() noexcept { changes_.clear(); }
+
+    private:
+        const IBoard* base_;
+        std::pmr::vector<std::pair<Coord, Player>> changes_; // Player::None = stone of the base removed
+
+        const std::pair<Coord, Player>* findChange(Coord c) const noexcept;
+        void record(Coord c, Player p);
+    };
+
+}
+
+#endif
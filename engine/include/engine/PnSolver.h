@@ -0,0 +1,116 @@
+#ifndef TIKTAKTOE_PNSOLVER_H
+#define TIKTAKTOE_PNSOLVER_H
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "GameState.h"
+#include "SearchLimits.h"
+
+namespace engine {
+
+    enum class SolveValue : std::uint8_t { Unknown = 0, Win = 1, Draw = 2, Loss = 3 };
+
+    // Depth-first proof-number (df-pn) solver for small finite boards with classic first-to-N win,
+    // no weights and no move costs. Positions are two bitboards, so width*height must fit in 64 cells.
+    // Proof/disproof numbers live in a fixed-size hash table, so memory does not grow with the search; positions
+    // are stored under their smallest symmetric variant, so rotations and reflections share one entry.
+    class PnSolver {
+    public:
+        struct Settings {
+            std::size_t tableEntries = std::size_t{1} << 18; // rounded up to a power of two
+
+            std::uint64_t maxNodes = 2'000'000; // per solve()/bestMove() call, 0 = unlimited
+        };
+
+        PnSolver();
+        explicit PnSolver(Settings s);
+
+        static bool supports(const RuleSet& rules, const IBoard& board);
+
+        // Game-theoretic value for the side to move. Unknown if the node budget or the limits ran out.
+        SolveValue solve(const GameState& state, const SearchLimits& limits = {});
+
+        // Perfect move for aiPlayer (must be the side to move). nullopt if not supported or not solved in budget.
+        std::optional<Coord> bestMove(const GameState& state, Player aiPlayer, SolveValue* value = nullptr,
+                                      const SearchLimits& limits = {});
+
+        std::uint64_t nodes() const noexcept { return nodes_; }
+
+        // Table lookups / hits of the last solve()/bestMove() call.
+        std::uint64_t tableProbes() const noexcept { return probes_; }
+        std::uint64_t tableHits() const noexcept { return hits_; }
+
+        // Drops all cached proof numbers (the table memory is kept).
+        void clear();
+
+    private:
+        struct Entry {
+            std::uint64_t x = 0;
+            std::uint64_t o = 0;
+            std::uint32_t pn = 0;
+            std::uint32_t dn = 0;
+            std::uint32_t work = 0;
+            std::uint8_t attacker = 0;
+            bool used = false;
+        };
+
+        struct Bounds {
+            std::uint32_t pn = 1;
+            std::uint32_t dn = 1;
+            bool known = false; // found in the table
+        };
+
+        struct Pos {
+            std::uint64_t bits[2]{};
+        };
+
+        Settings s_;
+
+        // Geometry of the configured board.
+        int width_ = 0;
+        int height_ = 0;
+        int N_ = 0;
+        int maxMoves_ = 0;
+        int cells_ = 0;
+        std::uint64_t full_ = 0;
+        std::vector<std::uint64_t> windows_;
+        std::vector<int> cellOrder_;
+
+        // Board symmetries other than the identity, as byte -> bits lookup tables ([byte][value]).
+        std::vector<std::vector<std::uint64_t>> symmetries_;
+        int bytes_ = 0;
+
+        std::vector<Entry> table_;
+        std::uint64_t nodes_ = 0;
+        mutable std::uint64_t probes_ = 0;
+        mutable std::uint64_t hits_ = 0;
+        bool aborted_ = false;
+        SearchLimits limits_;
+
+        void configure(const RuleSet& rules, const IBoard& board);
+        bool readPosition(const GameState& state, Pos& out) const;
+
+        std::uint64_t transformed(std::uint64_t bits, const std::vector<std::uint64_t>& perm) const noexcept;
+        Pos canonical(const Pos& pos) const noexcept; // smallest symmetric variant, the table key
+
+        std::size_t slot(const Pos& pos, int attacker) const noexcept;
+        Bounds lookup(const Pos& pos, int attacker) const noexcept;
+        void store(const Pos& pos, int attacker, Bounds b, std::uint64_t work);
+
+        bool hasLiveWindow(std::uint64_t blockers) const noexcept;
+        std::uint64_t winningCells(std::uint64_t own, std::uint64_t opp) const noexcept;
+
+        Bounds mid(const Pos& pos, int toMove, int attacker, std::uint32_t thpn, std::uint32_t thdn);
+        std::optional<bool> prove(const Pos& pos, int toMove, int attacker);
+        SolveValue valueFor(const Pos& pos, int toMove);
+    };
+
+    std::string toString(SolveValue v);
+
+}
+
+#endif
@@ -2,6 +2,7 @@
 #define TIKTAKTOE_RULESET_H
 #pragma once
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
@@ -44,6 +45,9 @@ namespace engine {
 
         // Validation (also normalizes some values). Returns list of warnings.
         std::vector<std::string> validateAndFix();
+
+        // Stable 64-bit hash of every field that affects play; keys files built offline for one rule set.
+        std::uint64_t fingerprint() const;
     };
 
     std::string toString(BoardTopology t);
@@ -0,0 +1,65 @@
+#ifndef TIKTAKTOE_SCOREBOUNDS_H
+#define TIKTAKTOE_SCOREBOUNDS_H
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "GameState.h"
+
+namespace engine {
+
+    // Cheap bounds on how far a player's lines and score can still move before the game ends on a finite board.
+    // A new line needs a window of N cells free of opponent stones with at most `moves` empties, so every empty
+    // cell gets the most it can add over the 4 directions and the best `moves` cells are summed. Losses (merges
+    // in ExactN / without subsegments, move costs, negative weights) are bounded the same way.
+    class ScoreBounds {
+    public:
+        struct Reach {
+            int minLines = 0;
+            int maxLines = 0;
+            long long minScore = 0;
+            long long maxScore = 0;
+            bool canWin = false; // a classic line or the target score is still reachable
+        };
+
+        ScoreBounds() = default;
+        ScoreBounds(const RuleSet& rules, int width, int height); // infinite boards: every reach() is unbounded
+
+        bool enabled() const noexcept { return width_ > 0; }
+
+        // Range of p's final lines/score after at most `moves` more moves of p (budget < 0 = unlimited).
+        // Not safe to call concurrently on one object: reuses scratch buffers.
+        Reach reach(const IBoard& board, Player p, int lines, long long score, int moves, long long budget = -1) const;
+        Reach reach(const GameState& state, Player p) const;
+
+        // Moves p can still make: alternating turns until board full / maxMoves (any share of them with budgets).
+        static int movesLeft(const GameState& state, Player p);
+
+        // Result the game ends with whatever both sides play, if already decided.
+        std::optional<GameResult> lockedResult(const GameState& state) const;
+
+    private:
+        RuleSet rules_{};
+        int width_ = 0;
+        int height_ = 0;
+        bool nonNegative_ = true;  // all weights >= 0
+        long long scoreBound_ = 0; // |score| never exceeds it
+        std::vector<long long> weight_;
+        std::vector<int> cost_;
+
+        mutable std::vector<std::uint8_t> state_;
+        mutable std::vector<int> free_;
+        mutable std::vector<int> costs_;
+        mutable std::vector<int> gainLines_;
+        mutable std::vector<int> lossLines_;
+        mutable std::vector<long long> gainScore_;
+        mutable std::vector<long long> lossScore_;
+        mutable std::vector<std::uint8_t> rel_;
+        mutable std::vector<long long> relW_;
+    };
+
+}
+
+#endif
@@ -13,9 +13,22 @@ namespace engine {
         int maxRunLen = 1;
     };
 
+    struct LineTotals {
+        int lines = 0;
+        long long score = 0;
+        int maxRunLen = 0;
+    };
+
     class Scoring {
     public:
         static MoveDelta computeMoveDelta(const IBoard& board, Coord c, Player p, const RuleSet& rules);
+
+        // Lines/score of all of p's runs on a finite board, as accumulated move by move via computeMoveDelta.
+        static LineTotals computeTotals(const IBoard& board, Player p, const RuleSet& rules);
+
+        // Upper bound on |score| of one player at any point of a game on a finite width x height board
+        // (weights plus move costs paid from score). Used to pack (lines, score) into a single number.
+        static long long scoreBound(const RuleSet& rules);
     };
 
 }
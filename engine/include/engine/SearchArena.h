@@ -0,0 +1,52 @@
+#ifndef TIKTAKTOE_SEARCHARENA_H
+#define TIKTAKTOE_SEARCHARENA_H
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+namespace engine {
+
+    // Monotonic arena for the scratch containers of one search, reset at the start of each decision.
+    // Allocations that overflow the buffer go to the heap and grow the buffer at the next reset, so a warmed-up
+    // arena serves a whole decision without touching the global allocator. Copies start with a fresh arena.
+    class SearchArena {
+    public:
+        explicit SearchArena(std::size_t initialBytes = std::size_t{64} * 1024);
+        SearchArena(const SearchArena& other);
+        SearchArena& operator=(const SearchArena& other);
+        ~SearchArena() = default;
+
+        // Invalidates everything allocated since the previous reset.
+        void reset();
+
+        std::pmr::memory_resource* resource() noexcept { return &*arena_; }
+
+        std::size_t capacity() const noexcept { return size_; }
+        std::size_t spilled() const noexcept { return upstream_.bytes; } // heap bytes since the last reset
+
+    private:
+        // Counts what the arena had to take from the heap.
+        class Upstream final : public std::pmr::memory_resource {
+        public:
+            std::size_t bytes = 0;
+
+        private:
+            void* do_allocate(std::size_t n, std::size_t align) override;
+            void do_deallocate(void* p, std::size_t n, std::size_t align) override;
+            bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+        };
+
+        std::size_t size_ = 0;
+        std::unique_ptr<std::byte[]> buffer_;
+        Upstream upstream_;
+        std::optional<std::pmr::monotonic_buffer_resource> arena_;
+
+        void allocate(std::size_t bytes);
+    };
+
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef TIKTAKTOE_SEARCHLIMITS_H
+#define TIKTAKTOE_SEARCHLIMITS_H
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+namespace engine {
+
+    // Bounds for one anytime search. A search that hits any of them stops and reports its best result so far.
+    struct SearchLimits {
+        using Clock = std::chrono::steady_clock;
+
+        std::optional<Clock::time_point> deadline;
+
+        std::uint64_t maxNodes = 0; // 0 = unlimited
+
+        const std::atomic<bool>* stop = nullptr; // cooperative cancellation, owned by the caller
+
+        static SearchLimits within(std::chrono::milliseconds budget) {
+            SearchLimits l;
+            l.deadline = Clock::now() + budget;
+            return l;
+        }
+
+        bool stopRequested() const noexcept { return stop && stop->load(std::memory_order_relaxed); }
+        bool timeUp() const noexcept { return deadline && Clock::now() >= *deadline; }
+        bool expired() const noexcept { return stopRequested() || timeUp(); }
+        bool nodesExhausted(std::uint64_t nodes) const noexcept { return maxNodes > 0 && nodes >= maxNodes; }
+
+        // Same deadline/stop with the node budget reduced by what is already spent (0 stays unlimited).
+        SearchLimits remaining(std::uint64_t spent) const noexcept {
+            SearchLimits l = *this;
+            if (maxNodes > 0) l.maxNodes = spent < maxNodes ? maxNodes - spent : 1;
+            return l;
+        }
+
+        // Tighter of the two deadlines.
+        SearchLimits capped(Clock::time_point until) const noexcept {
+            SearchLimits l = *this;
+            if (!l.deadline || until < *l.deadline) l.deadline = until;
+            return l;
+        }
+    };
+
+}
+
+#endif
@@ -0,0 +1,89 @@
+#ifndef TIKTAKTOE_SEARCHSTATS_H
+#define TIKTAKTOE_SEARCHSTATS_H
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+#include "Coord.h"
+#include "Scoring.h"
+
+namespace engine {
+
+    // Which stage of SimpleAI::chooseMove produced the move.
+    enum class MoveSource : std::uint8_t { None, Tablebase, OpeningBook, Classic3x3, ClassicSolver, EndgameSolver, Heuristic };
+
+    // Components of the heuristic score of the chosen move: total = firstPly - opponentBest * defenseMul + noise.
+    struct ScoreBreakdown {
+        long long firstPly = 0;
+        long long opponentBest = 0; // best reply after the move (two-ply only)
+        long long defenseMul = 0;
+        long long noise = 0;
+        long long total = 0;
+
+        MoveDelta delta{}; // lines/score the move adds for the mover
+        int cost = 0;
+    };
+
+    // Counters and timings of one chooseMove call.
+    struct SearchStats {
+        using Duration = std::chrono::nanoseconds;
+
+        MoveSource source = MoveSource::None;
+        std::optional<Coord> move;
+        bool limitHit = false; // deadline, node budget or stop flag cut the search short
+        bool resultLocked = false; // ScoreBounds: no play changes the result, the second ply was skipped
+
+        std::uint64_t nodes = 0; // heuristic evaluations + solver nodes
+
+        // Heuristic
+        std::size_t candidatesGenerated = 0;
+        std::size_t legalMoves = 0;
+        std::size_t symmetricSkipped = 0;     // legal moves equivalent to an earlier one by board symmetry
+        std::size_t topMoves = 0;             // first-ply moves kept after the sort
+        std::size_t secondPlyMoves = 0;       // of those, fully answered at the second ply
+        std::uint64_t classicEvals = 0;       // evaluations in classic mode
+        std::uint64_t scoreEvals = 0;         // evaluations in lines/score mode
+        std::uint64_t secondPlyReplies = 0;   // opponent replies scored
+
+        // Solvers
+        std::uint64_t solverNodes = 0;
+        std::uint64_t cacheProbes = 0;
+        std::uint64_t cacheHits = 0;
+
+        Duration solverTime{};
+        Duration candidateTime{};
+        Duration firstPlyTime{};
+        Duration sortTime{};
+        Duration secondPlyTime{};
+        Duration totalTime{};
+
+        ScoreBreakdown breakdown;
+
+        double cacheHitRate() const noexcept {
+            return cacheProbes ? static_cast<double>(cacheHits) / static_cast<double>(cacheProbes) : 0.0;
+        }
+    };
+
+    // Where a running chooseMove call is, for progress displays.
+    struct SearchProgress {
+        MoveSource stage = MoveSource::None;
+        int ply = 0;            // heuristic: 1 = scoring own moves, 2 = checking replies to the top ones
+        std::size_t done = 0;   // moves of the current ply finished
+        std::size_t total = 0;  // moves in it; 0 inside the solvers
+        std::uint64_t nodes = 0;
+        std::optional<Coord> best; // best move so far, if any
+        SearchStats::Duration elapsed{};
+    };
+
+    std::string toString(MoveSource s);
+
+    // One line of key=value pairs, times in microseconds. Meant for logs.
+    std::string toString(const SearchStats& s);
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef TIKTAKTOE_SYMMETRY_H
+#define TIKTAKTOE_SYMMETRY_H
+#pragma once
+
+#include <cstdint>
+
+#include "Board.h"
+#include "RuleSet.h"
+
+namespace engine {
+
+    // The dihedral symmetries of a finite board that leave the rules unchanged: line geometry always maps onto
+    // itself, so a transform qualifies when the active weight and cost functions take equal values on every
+    // cell and its image. Non-square boards only have the identity, the two mirrors and the half turn;
+    // infinite boards are treated as having the identity only.
+    //
+    // Transforms: 0 identity, 1 quarter turn, 2 half turn, 3 three-quarter turn,
+    //             4 mirror x, 5 mirror y, 6 transpose, 7 anti-transpose.
+    class BoardSymmetry {
+    public:
+        static constexpr int kTransforms = 8;
+
+        BoardSymmetry() = default;
+
+        static BoardSymmetry detect(const RuleSet& rules, int width, int height);
+
+        int width() const noexcept { return width_; }
+        int height() const noexcept { return height_; }
+
+        std::uint8_t mask() const noexcept { return mask_; }
+        bool has(int t) const noexcept { return (mask_ >> t) & 1u; }
+        bool trivial() const noexcept { return mask_ == 1u; }
+
+        Coord apply(int t, Coord c) const noexcept;
+        static int inverse(int t) noexcept { return t == 1 ? 3 : (t == 3 ? 1 : t); }
+
+        // Transforms of the group that map the position onto itself, stone for stone (bit 0 always set).
+        std::uint8_t stabilizer(const IBoard& board) const;
+
+        // Smallest position hash over the group, equal for all symmetric variants of a position.
+        // `transform` receives a transform that maps the position onto its canonical form.
+        std::uint64_t canonicalHash(const IBoard& board, int* transform = nullptr) const;
+
+    private:
+        int width_ = 0;
+        int height_ = 0;
+        std::uint8_t mask_ = 1;
+    };
+
+}
+
+#endif
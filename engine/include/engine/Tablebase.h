@@ -0,0 +1,68 @@
+#ifndef TIKTAKTOE_TABLEBASE_H
+#define TIKTAKTOE_TABLEBASE_H
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include "GameState.h"
+#include "MappedFile.h"
+
+namespace engine {
+
+    // Exact values of every reachable position on a small finite board, built offline by retrograde
+    // sweep and probed through a memory map (no parsing on load).
+    //
+    // Value of a position, for the side to move:
+    //   +-(kWinValue + empties)                     classic line / target score decides the game,
+    //   linesDiff * linesScale + scoreDiff          otherwise (final margin under optimal play).
+    class Tablebase {
+    public:
+        static constexpr int kMaxCells = 16;
+        static constexpr std::int32_t kWinValue = 1'000'000'000;
+        static constexpr std::int32_t kNoValue = std::numeric_limits<std::int32_t>::min(); // unreachable position
+
+        struct Header {
+            char magic[8]{};
+            std::uint32_t version = 0;
+            std::uint32_t width = 0;
+            std::uint32_t height = 0;
+            std::uint32_t reserved = 0;
+            std::uint64_t rulesFingerprint = 0;
+            std::uint64_t entryCount = 0;
+            std::int64_t linesScale = 0;
+        };
+
+        // Finite, width*height <= kMaxCells, no move costs.
+        static bool supports(const RuleSet& rules);
+
+        // Computes all positions in parallel and writes the file. Returns false and fills error on failure.
+        static bool generate(const RuleSet& rules, const std::string& path, unsigned threads, std::string* error = nullptr);
+
+        bool open(const std::string& path);
+        void close() noexcept;
+
+        bool isOpen() const noexcept { return entries_ != nullptr; }
+        const Header& header() const noexcept { return header_; }
+
+        bool matches(const RuleSet& rules) const noexcept;
+
+        // Value for the side to move, or nullopt if the position is not covered.
+        std::optional<std::int32_t> probe(const GameState& state) const;
+
+        // Best move for aiPlayer (must be the side to move).
+        std::optional<Coord> bestMove(const GameState& state, Player aiPlayer, std::int32_t* value = nullptr) const;
+
+    private:
+        MappedFile file_;
+        Header header_{};
+        const std::int32_t* entries_ = nullptr;
+
+        std::optional<std::uint64_t> indexOf(const GameState& state) const;
+    };
+
+}
+
+#endif
@@ -6,22 +6,34 @@
 #include <random>
 #include "engine/AI.h"
 
-#include "engine/FiniteBoard.h"
-#include "engine/InfiniteBoard.h"
+#include "engine/CandidateScratch.h"
+#include "engine/Classic3x3Table.h"
+#include "engine/OverlayBoard.h"
+#include "engine/ScoreBounds.h"
 #include "engine/Scoring.h"
 
 #include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstddef>
 #include <limits>
+#include <memory_resource>
 #include <random>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
 namespace engine {
 namespace {
 
+// Первый уровень сообщает о прогрессе раз в столько оценок.
+constexpr std::size_t kProgressEvery = 64;
+
+// Неполный эндшпиль лучше эвристики, только если досчитана хотя бы такая доля корневых ходов.
+constexpr std::size_t kEndgameMinFinishedPercent = 50;
+
+// Проверка «исход решён» проходит по всем клеткам дважды; на досках крупнее до конца партии всё равно далеко.
+constexpr long long kLockCheckMaxCells = 64 * 64;
+
 constexpr long long NEG_INF = (std::numeric_limits<long long>::min() / 4);
 
 struct SimPlayerState {
@@ -68,147 +80,170 @@ Coord defaultRef(const IBoard& board) {
     return Coord{0, 0};
 }
 
-std::unique_ptr<IBoard> cloneBoard(const IBoard& src) {
-    std::unique_ptr<IBoard> dst;
+// Контейнеры поиска берут память из арены SimpleAI.
+using CoordList = std::pmr::vector<Coord>;
 
-    if (src.isFinite()) {
-        dst = std::make_unique<FiniteBoard>(src.width(), src.height());
-    } else {
-        dst = std::make_unique<InfiniteBoard>();
+void neighborhoodCandidates(CandidateScratch& scratch, const IBoard& board, Coord ref, int radius,
+                            std::size_t maxCandidates, CoordList& out) {
+    const auto occ = board.occupied();
+    if (occ.empty()) {
+        out.assign(1, defaultRef(board));
+        return;
     }
+    const auto cells = scratch.neighborhood(board, occ, radius, ref, maxCandidates);
+    out.assign(cells.begin(), cells.end());
+}
 
-    for (const auto& [c, p] : src.occupied()) {
-        (void)dst->set(c, p);
+// То же множество, что и neighborhoodCandidates с радиусом фронта, но без обхода всех камней.
+void frontierCandidates(CandidateScratch& scratch, const FrontierMaps& frontier, Coord ref, std::size_t maxCandidates,
+                        CoordList& out) {
+    out.clear();
+    out.reserve(frontier.cells().size());
+    for (const auto& [c, cell] : frontier.cells()) {
+        (void)cell;
+        out.push_back(c);
     }
-    return dst;
+    out.resize(scratch.sortByDistance(out, ref, maxCandidates));
 }
 
-std::vector<Coord> neighborhoodCandidates(const IBoard& board, Coord ref, int radius, std::size_t maxCandidates) {
-    std::vector<Coord> out;
-    if (radius < 0) radius = 0;
-
-    const auto occ = board.occupied();
-    if (occ.empty()) {
-        out.push_back(defaultRef(board));
-        return out;
+// Кандидаты после пробного хода `placed` (уже стоит на доске): фронт без этой клетки плюс пустые клетки вокруг неё.
+void frontierCandidatesAfter(CandidateScratch& scratch, const IBoard& board, const FrontierMaps& frontier, Coord placed,
+                             int radius, std::size_t maxCandidates, CoordList& out) {
+    out.clear();
+    out.reserve(frontier.cells().size() + static_cast<std::size_t>((2 * radius + 1) * (2 * radius + 1)));
+    for (const auto& [c, cell] : frontier.cells()) {
+        (void)cell;
+        if (c != placed) out.push_back(c);
     }
-
-    std::unordered_set<Coord, CoordHash> set;
-    set.reserve(std::min<std::size_t>(maxCandidates > 0 ? maxCandidates * 2 : 2048, 8192));
-
-    for (const auto& [cell, p] : occ) {
-        (void)p;
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                Coord c{cell.x + dx, cell.y + dy};
-                if (board.isFinite() && !board.inBounds(c)) continue;
-                if (board.get(c) != Player::None) continue;
-                set.insert(c);
-            }
+    for (int dy = -radius; dy <= radius; ++dy) {
+        for (int dx = -radius; dx <= radius; ++dx) {
+            const Coord c{placed.x + dx, placed.y + dy};
+            if (board.isFinite() && !board.inBounds(c)) continue;
+            if (board.get(c) != Player::None) continue;
+            if (frontier.find(c) == nullptr) out.push_back(c);
         }
     }
-
-    out.assign(set.begin(), set.end());
-
-    std::sort(out.begin(), out.end(), [&](const Coord& a, const Coord& b) {
-        const long long da = manhattan(a, ref);
-        const long long db = manhattan(b, ref);
-        if (da != db) return da < db;
-        if (a.y != b.y) return a.y < b.y;
-        return a.x < b.x;
-    });
-
-    if (maxCandidates > 0 && out.size() > maxCandidates) {
-        out.resize(maxCandidates);
-    }
-    return out;
+    out.resize(scratch.sortByDistance(out, placed, maxCandidates));
 }
 
-std::vector<Coord> allEmptyFinite(const IBoard& board) {
-    std::vector<Coord> out;
-    if (!board.isFinite()) return out;
+constexpr Coord kRays[8] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}};
 
-    out.reserve(static_cast<std::size_t>(board.width()) * static_cast<std::size_t>(board.height()));
-    for (int y = 0; y < board.height(); ++y) {
-        for (int x = 0; x < board.width(); ++x) {
-            Coord c{x, y};
-            if (board.get(c) == Player::None) out.push_back(c);
+// Есть ли камень на одной из 4 линий через c не дальше reach клеток.
+bool stoneOnLine(const IBoard& board, Coord c, int reach) {
+    for (const Coord d : kRays) {
+        for (int k = 1; k <= reach; ++k) {
+            const Coord q{c.x + d.x * k, c.y + d.y * k};
+            if (board.isFinite() && !board.inBounds(q)) break;
+            if (board.get(q) != Player::None) return true;
         }
     }
-    return out;
+    return false;
 }
 
-struct LinePotential {
-    bool canWin = false;
-    int bestLen = 1;
-    int bestOpenEnds = 0;
-    long long value = 0;
-};
-
-long long directionValue(int len, int openEnds, int N) {
-    if (len <= 0) return 0;
-    if (len >= N) return 1'000'000'000'000LL;
-
-    const long long l = static_cast<long long>(len);
-    const long long base = l * l * l * l; // l^4
+// Пустые клетки на линиях камней (не дальше reach по каждой из 4 линий), отобранные по угрозе:
+// сумма потенциалов обоих игроков, при равенстве ближе к ref. Сначала берётся близкий радиус; если ни один
+// ход ни одной стороны не даёт линию хотя бы из N-2 камней вместе с ним самим (тихая позиция), радиус
+// расширяется до N-1.
+void lineCandidates(CandidateScratch& scratch, const IBoard& board, const LinePatterns& patterns,
+                    const FrontierMaps* frontier, Coord ref, int radius, std::size_t maxCandidates, CoordList& out) {
+    struct Ranked {
+        Coord c{};
+        long long threat = 0;
+        long long dist = 0;
+    };
 
-    const long long oe = (openEnds == 2 ? 10 : (openEnds == 1 ? 3 : 1));
+    const int N = patterns.N();
+    const int wide = std::max(1, N - 1);
+    const int narrow = std::clamp(radius, 1, wide);
 
-    long long bonus = 1;
-    if (N >= 2) {
-        if (len == N - 1) bonus = 2000;
-        else if (len == N - 2) bonus = 200;
-        else if (len == N - 3) bonus = 40;
+    if (board.isFinite()) {
+        scratch.beginMarks(Coord{0, 0}, Coord{board.width() - 1, board.height() - 1});
+    } else {
+        scratch.beginMarks();
     }
-    return base * oe * bonus;
-}
-
-LinePotential computePotentialAtEmptyCell(const IBoard& board, const RuleSet& rules, Player p, Coord c) {
-    LinePotential pot;
-    const int N = std::max(1, rules.N);
-
-    struct Dir { int dx; int dy; };
-    const Dir dirs[4] = {{1,0}, {0,1}, {1,1}, {1,-1}};
+    out.clear();
+    std::pmr::vector<Ranked> ranked(out.get_allocator());
+    bool quiet = true;
+
+    auto add = [&](Coord c) {
+        if (!scratch.mark(c)) return;
+        const FrontierCell* fc = frontier ? frontier->find(c) : nullptr;
+        const LinePotential x = fc ? fc->of(Player::X).potential : patterns.potentialAt(board, Player::X, c);
+        const LinePotential o = fc ? fc->of(Player::O).potential : patterns.potentialAt(board, Player::O, c);
+        if (std::max(x.bestLen, o.bestLen) >= N - 2) quiet = false;
+        ranked.push_back({c, x.value + o.value, manhattan(c, ref)});
+    };
 
-    for (const auto& d : dirs) {
-        int left = 0;
-        Coord t{c.x - d.dx, c.y - d.dy};
-        while (board.inBounds(t) && board.get(t) == p) {
-            ++left;
-            t.x -= d.dx;
-            t.y -= d.dy;
+    auto collect = [&](int reach, const CoordList& stones) {
+        for (const Coord s : stones) {
+            for (const Coord d : kRays) {
+                for (int k = 1; k <= reach; ++k) {
+                    const Coord c{s.x + d.x * k, s.y + d.y * k};
+                    if (board.isFinite() && !board.inBounds(c)) break;
+                    if (board.get(c) == Player::None) add(c);
+                }
+            }
         }
+    };
 
-        int right = 0;
-        t = Coord{c.x + d.dx, c.y + d.dy};
-        while (board.inBounds(t) && board.get(t) == p) {
-            ++right;
-            t.x += d.dx;
-            t.y += d.dy;
+    // Фронт уже содержит все пустые клетки в квадрате своего радиуса: обход камней не нужен.
+    // Камни копируются в арену: доска отдаёт их только временным вектором, а нужны они до двух раз.
+    CoordList stones(out.get_allocator());
+    auto loadStones = [&]() {
+        const auto occ = board.occupied();
+        stones.reserve(occ.size());
+        for (const auto& [c, p] : occ) {
+            (void)p;
+            stones.push_back(c);
         }
+    };
+    if (frontier && frontier->radius() >= narrow && !frontier->cells().empty()) {
+        ranked.reserve(frontier->cells().size());
+        for (const auto& [c, cell] : frontier->cells()) {
+            (void)cell;
+            if (stoneOnLine(board, c, narrow)) add(c);
+        }
+    } else {
+        loadStones();
+        collect(narrow, stones);
+    }
 
-        const int len = left + 1 + right;
+    if (quiet && wide > narrow) {
+        if (stones.empty()) loadStones();
+        collect(wide, stones);
+    }
 
-        Coord leftEnd{c.x - (left + 1) * d.dx, c.y - (left + 1) * d.dy};
-        Coord rightEnd{c.x + (right + 1) * d.dx, c.y + (right + 1) * d.dy};
+    if (ranked.empty()) return;
 
-        int openEnds = 0;
-        if (board.inBounds(leftEnd) && board.get(leftEnd) == Player::None) ++openEnds;
-        if (board.inBounds(rightEnd) && board.get(rightEnd) == Player::None) ++openEnds;
+    const auto better = [](const Ranked& a, const Ranked& b) {
+        if (a.threat != b.threat) return a.threat > b.threat;
+        if (a.dist != b.dist) return a.dist < b.dist;
+        if (a.c.y != b.c.y) return a.c.y < b.c.y;
+        return a.c.x < b.c.x;
+    };
 
-        if (len >= N) pot.canWin = true;
+    // Частичный отбор: полная сортировка нужна только оставшимся кандидатам.
+    if (maxCandidates > 0 && ranked.size() > maxCandidates) {
+        std::nth_element(ranked.begin(), ranked.begin() + static_cast<std::ptrdiff_t>(maxCandidates), ranked.end(), better);
+        ranked.resize(maxCandidates);
+    }
+    std::sort(ranked.begin(), ranked.end(), better);
 
-        if (len > pot.bestLen) {
-            pot.bestLen = len;
-            pot.bestOpenEnds = openEnds;
-        } else if (len == pot.bestLen && openEnds > pot.bestOpenEnds) {
-            pot.bestOpenEnds = openEnds;
-        }
+    out.reserve(ranked.size());
+    for (const auto& r : ranked) out.push_back(r.c);
+}
 
-        pot.value += directionValue(len, openEnds, N);
-    }
+void allEmptyFinite(const IBoard& board, CoordList& out) {
+    out.clear();
+    if (!board.isFinite()) return;
 
-    return pot;
+    out.reserve(static_cast<std::size_t>(board.width()) * static_cast<std::size_t>(board.height()));
+    for (int y = 0; y < board.height(); ++y) {
+        for (int x = 0; x < board.width(); ++x) {
+            Coord c{x, y};
+            if (board.get(c) == Player::None) out.push_back(c);
+        }
+    }
 }
 
 enum class AiMode { Classic, ScoreLike };
@@ -239,16 +274,18 @@ long long distancePenalty(const IBoard& board, Coord c, Coord ref, long long mul
 
 long long evalClassicMove(const IBoard& board,
                           const RuleSet& rules,
+                          const LinePatterns& patterns,
                           Player p,
                           Coord c,
                           const SimPlayerState& self,
-                          Coord ref) {
+                          Coord ref,
+                          const FrontierCell* pre) {
     if (!isMoveLegalForPlayer(board, rules, p, c, self.budget)) return NEG_INF;
 
     const int cost = costAt(rules, c);
 
-    const LinePotential myPot = computePotentialAtEmptyCell(board, rules, p, c);
-    const LinePotential opPot = computePotentialAtEmptyCell(board, rules, other(p), c);
+    const LinePotential myPot = pre ? pre->of(p).potential : patterns.potentialAt(board, p, c);
+    const LinePotential opPot = pre ? pre->of(other(p)).potential : patterns.potentialAt(board, other(p), c);
 
     constexpr long long WIN_NOW   = 9'000'000'000'000LL;
     constexpr long long BLOCK_NOW = 8'000'000'000'000LL;
@@ -273,16 +310,18 @@ long long evalClassicMove(const IBoard& board,
 
 long long evalScoreMove(const IBoard& board,
                         const RuleSet& rules,
+                        const LinePatterns& patterns,
                         Player p,
                         Coord c,
                         const SimPlayerState& self,
-                        Coord ref) {
+                        Coord ref,
+                        const FrontierCell* pre) {
     if (!isMoveLegalForPlayer(board, rules, p, c, self.budget)) return NEG_INF;
 
     const int cost = costAt(rules, c);
 
     // Инкрементальная оценка "прибавки" по правилам линий/веса.
-    const MoveDelta d = Scoring::computeMoveDelta(board, c, p, rules);
+    const MoveDelta d = pre ? pre->of(p).delta : Scoring::computeMoveDelta(board, c, p, rules);
 
     // Если одновременно включена classicWin — она имеет приоритет. Значит, AI должен это уважать.
     if (rules.classicWin && d.maxRunLen >= rules.N) {
@@ -313,8 +352,8 @@ long long evalScoreMove(const IBoard& board,
         s += effScoreDelta * scoreW;
     }
 
-    const LinePotential myPot = computePotentialAtEmptyCell(board, rules, p, c);
-    const LinePotential opPot = computePotentialAtEmptyCell(board, rules, other(p), c);
+    const LinePotential myPot = pre ? pre->of(p).potential : patterns.potentialAt(board, p, c);
+    const LinePotential opPot = pre ? pre->of(other(p)).potential : patterns.potentialAt(board, other(p), c);
 
     s += myPot.value * 2;
     s += opPot.value * 1;
@@ -327,94 +366,17 @@ long long evalScoreMove(const IBoard& board,
 
 long long evalMoveByMode(const IBoard& board,
                          const RuleSet& rules,
+                         const LinePatterns& patterns,
                          AiMode mode,
                          Player p,
                          Coord c,
                          const SimPlayerState& self,
-                         Coord ref) {
+                         Coord ref,
+                         const FrontierCell* pre = nullptr) {
     if (mode == AiMode::Classic) {
-        return evalClassicMove(board, rules, p, c, self, ref);
-    }
-    return evalScoreMove(board, rules, p, c, self, ref);
-}
-
-Player winner3x3(const std::array<Player, 9>& b) {
-    const int lines[8][3] = {
-        {0,1,2}, {3,4,5}, {6,7,8},
-        {0,3,6}, {1,4,7}, {2,5,8},
-        {0,4,8}, {2,4,6}
-    };
-
-    for (const auto& ln : lines) {
-        const Player p = b[ln[0]];
-        if (p != Player::None && p == b[ln[1]] && p == b[ln[2]]) {
-            return p;
-        }
-    }
-    return Player::None;
-}
-
-bool boardFull3x3(const std::array<Player, 9>& b) {
-    return std::none_of(b.begin(), b.end(), [](Player p) { return p == Player::None; });
-}
-
-int minimax3x3(std::array<Player, 9>& b, Player toMove, Player aiPlayer, int depth) {
-    const Player w = winner3x3(b);
-    if (w == aiPlayer) return 10 - depth;
-    if (w == other(aiPlayer)) return depth - 10;
-    if (boardFull3x3(b)) return 0;
-
-    if (toMove == aiPlayer) {
-        int best = -1000;
-        for (int i = 0; i < 9; ++i) {
-            if (b[i] != Player::None) continue;
-            b[i] = toMove;
-            best = std::max(best, minimax3x3(b, other(toMove), aiPlayer, depth + 1));
-            b[i] = Player::None;
-        }
-        return best;
-    } else {
-        int best = 1000;
-        for (int i = 0; i < 9; ++i) {
-            if (b[i] != Player::None) continue;
-            b[i] = toMove;
-            best = std::min(best, minimax3x3(b, other(toMove), aiPlayer, depth + 1));
-            b[i] = Player::None;
-        }
-        return best;
-    }
-}
-
-std::optional<Coord> choosePerfectClassic3x3(const GameState& state, Player aiPlayer) {
-    std::array<Player, 9> b{};
-    for (int y = 0; y < 3; ++y) {
-        for (int x = 0; x < 3; ++x) {
-            b[y * 3 + x] = state.board().get(Coord{x, y});
-        }
-    }
-
-    int bestScore = -1000;
-    std::optional<int> bestIdx;
-
-    // Лёгкий приоритет центра при равенстве
-    const int preferOrder[9] = {4, 0,2,6,8, 1,3,5,7};
-
-    for (int k = 0; k < 9; ++k) {
-        const int i = preferOrder[k];
-        if (b[i] != Player::None) continue;
-        b[i] = aiPlayer;
-        int s = minimax3x3(b, other(aiPlayer), aiPlayer, 1);
-        b[i] = Player::None;
-
-        if (!bestIdx || s > bestScore) {
-            bestScore = s;
-            bestIdx = i;
-        }
+        return evalClassicMove(board, rules, patterns, p, c, self, ref, pre);
     }
-
-    if (!bestIdx) return std::nullopt;
-    const int idx = *bestIdx;
-    return Coord{idx % 3, idx / 3};
+    return evalScoreMove(board, rules, patterns, p, c, self, ref, pre);
 }
 
 bool isPerfect3x3Case(const GameState& state, const RuleSet& rules) {
@@ -423,6 +385,7 @@ bool isPerfect3x3Case(const GameState& state, const RuleSet& rules) {
 
     if (!rules.classicWin) return false;
     if (rules.N != 3) return false;
+    if (rules.maxMoves > 0 && rules.maxMoves < 9) return false;
 
     if (rules.weightsEnabled) return false;
     if (rules.moveCostsEnabled) return false;
@@ -430,66 +393,77 @@ bool isPerfect3x3Case(const GameState& state, const RuleSet& rules) {
     return true;
 }
 
-}
-SimpleAI::SimpleAI(Settings s) : s_(s) {
-    if (s_.seed == 0) {
-        std::random_device rd;
-        rng_ = std::mt19937(rd());
-    } else {
-        rng_ = std::mt19937(s_.seed);
+// O(1): готовый ход из таблицы, посчитанной на этапе компиляции.
+std::optional<Coord> choosePerfectClassic3x3(const GameState& state, Player aiPlayer) {
+    int idx = 0;
+    int mul = 1;
+    int stones = 0;
+    for (int i = 0; i < 9; ++i) {
+        const Player p = state.board().get(Coord{i % 3, i / 3});
+        if (p != Player::None) ++stones;
+        idx += mul * static_cast<int>(p);
+        mul *= 3;
     }
+    if (stones != state.moveCount()) return std::nullopt;
+
+    const Player toMove = (stones % 2 == 0) ? Player::X : Player::O;
+    if (toMove != aiPlayer) return std::nullopt;
+
+    const Classic3x3Entry& e = classic3x3Lookup(idx);
+    if (e.move > 8) return std::nullopt;
+    return Coord{e.move % 3, e.move / 3};
 }
 
-std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlayer) {
-    if (state.isGameOver()) return std::nullopt;
+bool useClassicSolver(const GameState& state, const RuleSet& rules, int maxCells) {
+    if (!PnSolver::supports(rules, state.board())) return false;
+    const long long cells = static_cast<long long>(state.board().width()) * state.board().height();
+    return cells <= maxCells;
+}
 
+// Легальные ходы p в корне, самые важные первыми: кандидаты по линиям (или фронт / окрестность ref), при их
+// отсутствии — любые свободные клетки; из симметричных ходов остаётся по одному.
+void rootMoves(CandidateScratch& scratch, const SimpleAI::Settings& s, const GameState& state, const IBoard& board,
+               Player p, long long budget, Coord ref, CoordList& legal, SearchStats& stats) {
+    std::pmr::memory_resource* mem = legal.get_allocator().resource();
     const RuleSet& rules = state.rules();
-    const AiMode mode = selectMode(rules);
+    const FrontierMaps& frontier = state.frontier();
+    const bool useFrontier = frontier.radius() == s.candidateRadius && !frontier.cells().empty();
 
-    if (s_.enablePerfectClassic3x3 && isPerfect3x3Case(state, rules)) {
-        return choosePerfectClassic3x3(state, aiPlayer);
+    CoordList cand(mem);
+    if (s.lineCandidates) {
+        lineCandidates(scratch, board, state.linePatterns(), frontier.enabled() ? &frontier : nullptr, ref,
+                       s.candidateRadius, s.maxCandidates, cand);
     }
+    if (cand.empty()) {
+        if (useFrontier) {
+            frontierCandidates(scratch, frontier, ref, s.maxCandidates, cand);
+        } else {
+            neighborhoodCandidates(scratch, board, ref, s.candidateRadius, s.maxCandidates, cand);
+        }
+    }
+    stats.candidatesGenerated = cand.size();
 
-    auto boardPtr = cloneBoard(state.board());
-    IBoard& board = *boardPtr;
-
-    const Player opp = other(aiPlayer);
-
-    const SimPlayerState aiS = simStatsFrom(state, aiPlayer);
-    const SimPlayerState opS = simStatsFrom(state, opp);
-
-    Coord ref = state.lastMove().value_or(defaultRef(board));
-
-    std::vector<Coord> cand = neighborhoodCandidates(board, ref, s_.candidateRadius, s_.maxCandidates);
-
-    std::vector<Coord> legal;
+    legal.clear();
     legal.reserve(cand.size());
     for (const auto& c : cand) {
-        if (isMoveLegalForPlayer(board, rules, aiPlayer, c, aiS.budget)) {
+        if (isMoveLegalForPlayer(board, rules, p, c, budget)) {
             legal.push_back(c);
         }
     }
 
     if (legal.empty() && board.isFinite()) {
-        auto all = allEmptyFinite(board);
-        Coord center = defaultRef(board);
-
-        std::sort(all.begin(), all.end(), [&](const Coord& a, const Coord& b) {
-            const long long da = manhattan(a, center);
-            const long long db = manhattan(b, center);
-            if (da != db) return da < db;
-            if (a.y != b.y) return a.y < b.y;
-            return a.x < b.x;
-        });
+        CoordList all(mem);
+        allEmptyFinite(board, all);
+        scratch.sortByDistance(all, defaultRef(board), 0);
 
         for (const auto& c : all) {
-            if (isMoveLegalForPlayer(board, rules, aiPlayer, c, aiS.budget)) {
+            if (isMoveLegalForPlayer(board, rules, p, c, budget)) {
                 legal.push_back(c);
             }
         }
 
-        if (s_.maxCandidates > 0 && legal.size() > s_.maxCandidates) {
-            legal.resize(s_.maxCandidates);
+        if (s.maxCandidates > 0 && legal.size() > s.maxCandidates) {
+            legal.resize(s.maxCandidates);
         }
     }
 
@@ -500,7 +474,7 @@ std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlaye
                 for (int dx = -r; dx <= r && !found; ++dx) {
                     Coord c{ref.x + dx, ref.y + dy};
                     if (board.get(c) != Player::None) continue;
-                    if (isMoveLegalForPlayer(board, rules, aiPlayer, c, aiS.budget)) {
+                    if (isMoveLegalForPlayer(board, rules, p, c, budget)) {
                         legal.push_back(c);
                         found = true;
                     }
@@ -509,46 +483,276 @@ std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlaye
         }
     }
 
-    if (legal.empty()) return std::nullopt;
+    // Симметричные ходы дают симметричные позиции: оцениваем по одному представителю орбиты (первому по порядку).
+    const BoardSymmetry& symmetry = state.symmetry();
+    if (!symmetry.trivial()) {
+        const std::uint8_t stab = symmetry.stabilizer(board);
+        if (stab != 1) {
+            scratch.beginMarks(Coord{0, 0}, Coord{board.width() - 1, board.height() - 1});
+            const std::size_t before = legal.size();
+            std::erase_if(legal, [&](Coord c) {
+                if (!scratch.mark(c)) return true;
+                for (int t = 1; t < BoardSymmetry::kTransforms; ++t) {
+                    if ((stab >> t) & 1u) (void)scratch.mark(symmetry.apply(t, c));
+                }
+                return false;
+            });
+            stats.symmetricSkipped = before - legal.size();
+        }
+    }
+}
+
+// Подсказанные ходы встают в начало списка (если легальны), остальные сохраняют порядок.
+void promoteSeeds(const IBoard& board, const RuleSet& rules, Player p, long long budget, const std::vector<Coord>& seeds,
+                  CoordList& legal) {
+    for (auto it = seeds.rbegin(); it != seeds.rend(); ++it) {
+        const auto pos = std::find(legal.begin(), legal.end(), *it);
+        if (pos != legal.end()) {
+            std::rotate(legal.begin(), pos, pos + 1);
+        } else if (isMoveLegalForPlayer(board, rules, p, *it, budget)) {
+            legal.insert(legal.begin(), *it);
+        }
+    }
+}
+
+}
+
+SimpleAI::SimpleAI() : SimpleAI(Settings{}) {}
+
+SimpleAI::SimpleAI(Settings s) : s_(s), solver_(PnSolver::Settings{std::size_t{1} << 18, s.classicSolverNodes}) {
+    if (!s_.enablePerfectClassic3x3) s_.enableClassicSolver = false; // старое имя настройки
+    if (s_.seed == 0) {
+        std::random_device rd;
+        rng_ = std::mt19937(rd());
+    } else {
+        rng_ = std::mt19937(s_.seed);
+    }
+}
+
+std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlayer) {
+    return chooseMove(state, aiPlayer, SearchLimits{});
+}
+
+std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlayer, const SearchLimits& limits,
+                                          const std::vector<Coord>& seeds) {
+    using Clock = std::chrono::steady_clock;
+
+    const auto startTime = Clock::now();
+    stats_ = SearchStats{};
+
+    auto finish = [&](MoveSource source, std::optional<Coord> mv) {
+        stats_.source = mv ? source : MoveSource::None;
+        stats_.move = mv;
+        if (mv) {
+            stats_.breakdown.delta = Scoring::computeMoveDelta(state.board(), *mv, aiPlayer, state.rules());
+            stats_.breakdown.cost = costAt(state.rules(), *mv);
+        }
+        stats_.totalTime = Clock::now() - startTime;
+        if (onStats_) onStats_(stats_);
+        return mv;
+    };
+
+    auto report = [&](MoveSource stage, int ply, std::size_t done, std::size_t total, std::optional<Coord> best) {
+        if (!onProgress_) return;
+        SearchProgress pr;
+        pr.stage = stage;
+        pr.ply = ply;
+        pr.done = done;
+        pr.total = total;
+        pr.nodes = stats_.nodes;
+        pr.best = best;
+        pr.elapsed = Clock::now() - startTime;
+        onProgress_(pr);
+    };
+
+    if (state.isGameOver()) return finish(MoveSource::None, std::nullopt);
+
+    const RuleSet& rules = state.rules();
+    const LinePatterns& patterns = state.linePatterns();
+    const AiMode mode = selectMode(rules);
+
+    if (tablebase_ && tablebase_->matches(rules)) {
+        if (auto mv = tablebase_->bestMove(state, aiPlayer)) return finish(MoveSource::Tablebase, mv);
+    }
+
+    // Книга хранит ход стороны, чья очередь; за другого игрока она не отвечает.
+    if (book_ && aiPlayer == state.currentPlayer()) {
+        if (auto mv = book_->probe(state)) return finish(MoveSource::OpeningBook, mv);
+    }
+
+    if (s_.enableClassicSolver && isPerfect3x3Case(state, rules)) {
+        if (auto mv = choosePerfectClassic3x3(state, aiPlayer)) return finish(MoveSource::Classic3x3, mv);
+    }
+
+    // Узлы: оценки ходов эвристикой плюс узлы решателей.
+    std::uint64_t& nodes = stats_.nodes;
+    auto outOfBudget = [&]() {
+        if (limits.nodesExhausted(nodes) || limits.expired()) stats_.limitHit = true;
+        return stats_.limitHit;
+    };
+    auto countEval = [&]() {
+        ++nodes;
+        if (mode == AiMode::Classic) ++stats_.classicEvals;
+        else ++stats_.scoreEvals;
+    };
+
+    if (s_.enableClassicSolver && useClassicSolver(state, rules, s_.classicSolverMaxCells) && !outOfBudget()) {
+        report(MoveSource::ClassicSolver, 0, 0, 0, std::nullopt);
+        const auto t = Clock::now();
+        SolveValue v = SolveValue::Unknown;
+        const auto mv = solver_.bestMove(state, aiPlayer, &v, limits.remaining(nodes));
+        nodes += solver_.nodes();
+        stats_.solverNodes += solver_.nodes();
+        stats_.cacheProbes += solver_.tableProbes();
+        stats_.cacheHits += solver_.tableHits();
+        stats_.solverTime += Clock::now() - t;
+        // Проигранную позицию доигрываем эвристикой: она чаще ловит ошибки соперника.
+        if (mv && v != SolveValue::Loss) return finish(MoveSource::ClassicSolver, mv);
+    }
+
+    // Исход уже не зависит от игры (гонка по очкам решена): перебор ничего не изменит, хватает первого уровня.
+    const IBoard& game = state.board();
+    if (game.isFinite() && static_cast<long long>(game.width()) * game.height() <= kLockCheckMaxCells) {
+        const ScoreBounds bounds(rules, game.width(), game.height());
+        stats_.resultLocked = bounds.lockedResult(state).has_value();
+    }
+
+    if (s_.enableEndgameSolver && !stats_.resultLocked && EndgameSolver::supports(rules, state.board())
+        && EndgameSolver::emptyCells(state) <= s_.endgameMaxEmpties && !outOfBudget()) {
+        report(MoveSource::EndgameSolver, 0, 0, 0, std::nullopt);
+        const auto t = Clock::now();
+        const auto until = t + std::chrono::milliseconds(s_.endgameTimeMs);
+        const auto r = endgame_.solve(state, aiPlayer, limits.remaining(nodes).capped(until));
+        nodes += r.nodes;
+        stats_.solverNodes += r.nodes;
+        stats_.cacheProbes += r.tableProbes;
+        stats_.cacheHits += r.tableHits;
+        stats_.solverTime += Clock::now() - t;
+        const bool enough = r.exact || r.rootsFinished * 100 >= r.rootsTotal * kEndgameMinFinishedPercent;
+        if (r.move && enough) return finish(MoveSource::EndgameSolver, r.move);
+    }
+
+    auto phaseStart = Clock::now();
+
+    // Вся временная память эвристики до конца решения берётся из арены.
+    arena_.reset();
+    std::pmr::memory_resource* mem = arena_.resource();
+
+    // Пробные камни второго уровня живут в оверлее, доска партии не копируется.
+    OverlayBoard board(state.board(), mem);
+
+    const Player opp = other(aiPlayer);
+
+    const SimPlayerState aiS = simStatsFrom(state, aiPlayer);
+    const SimPlayerState opS = simStatsFrom(state, opp);
+
+    Coord ref = state.lastMove().value_or(defaultRef(board));
+
+    const FrontierMaps& frontier = state.frontier();
+    const bool useFrontier = frontier.radius() == s_.candidateRadius && !frontier.cells().empty();
+
+    CoordList legal(mem);
+    rootMoves(scratch_, s_, state, board, aiPlayer, aiS.budget, ref, legal, stats_);
+
+    // Подсказки (например, ответы, найденные на времени соперника) оцениваются первыми на обоих уровнях и не
+    // отсекаются maxTopMoves (см. ниже сортировку).
+    if (!seeds.empty()) promoteSeeds(board, rules, aiPlayer, aiS.budget, seeds, legal);
+
+    stats_.legalMoves = legal.size();
+    stats_.candidateTime = Clock::now() - phaseStart;
+
+    if (legal.empty()) return finish(MoveSource::None, std::nullopt);
 
     struct ScoredMove {
         Coord c{};
         long long score = NEG_INF;
     };
 
-    std::vector<ScoredMove> scored;
+    phaseStart = Clock::now();
+
+    std::pmr::vector<ScoredMove> scored(mem);
     scored.reserve(legal.size());
 
+    // Кандидаты идут по важности: подсказки, затем по угрозе (без lineCandidates — по близости к последнему
+    // ходу), так что при остановке оценены самые опасные клетки.
+    bool stopped = false;
     for (const auto& c : legal) {
-        const long long s = evalMoveByMode(board, rules, mode, aiPlayer, c, aiS, ref);
+        if (!scored.empty() && outOfBudget()) {
+            stopped = true;
+            break;
+        }
+        if (scored.size() % kProgressEvery == 0) report(MoveSource::Heuristic, 1, scored.size(), legal.size(), std::nullopt);
+        // На корне доска совпадает с доской партии: оценки клеток фронта уже посчитаны.
+        const long long s = evalMoveByMode(board, rules, patterns, mode, aiPlayer, c, aiS, ref, state.frontier().find(c));
+        countEval();
         scored.push_back({c, s});
     }
 
+    stats_.firstPlyTime = Clock::now() - phaseStart;
+    phaseStart = Clock::now();
+
     std::sort(scored.begin(), scored.end(), [](const ScoredMove& a, const ScoredMove& b) {
         return a.score > b.score;
     });
 
-    if (s_.maxTopMoves > 0 && scored.size() > s_.maxTopMoves) {
-        scored.resize(s_.maxTopMoves);
+    // Подсказки — снова в начало, в своём порядке: второй уровень, где уходит время, проверяет их первыми.
+    // Поворот вместо stable_partition: без временного буфера вне арены.
+    std::size_t seeded = 0;
+    for (auto it = seeds.rbegin(); it != seeds.rend(); ++it) {
+        const auto pos = std::find_if(scored.begin() + static_cast<std::ptrdiff_t>(seeded), scored.end(),
+                                      [&](const ScoredMove& m) { return m.c == *it; });
+        if (pos == scored.end()) continue;
+        std::rotate(scored.begin(), pos, pos + 1);
+        ++seeded;
     }
 
+    const std::size_t keep = std::max(s_.maxTopMoves, seeded);
+    if (s_.maxTopMoves > 0 && scored.size() > keep) {
+        scored.resize(keep);
+    }
+
+    stats_.sortTime = Clock::now() - phaseStart;
+    stats_.topMoves = scored.size();
+
     std::uniform_int_distribution<int> noise(0, 9999);
 
     long long bestFinal = NEG_INF;
     std::optional<Coord> best;
 
-    if (!s_.enableTwoPly) {
-        for (const auto& m : scored) {
-            long long s = m.score + noise(rng_);
-            if (!best || s > bestFinal) {
-                bestFinal = s;
-                best = m.c;
-            }
+    auto consider = [&](Coord c, long long firstPly, long long oppBest, long long defenseMul,
+                        std::optional<Coord> reply = std::nullopt) {
+        const long long n = noise(rng_);
+        const long long final = firstPly - oppBest * defenseMul + n;
+        if (lines_) {
+            AnalysedMove line{c, final, firstPly, {c}};
+            if (reply) line.pv.push_back(*reply);
+            lines_->push_back(std::move(line));
+        }
+        if (!best || final > bestFinal) {
+            bestFinal = final;
+            best = c;
+            stats_.breakdown.firstPly = firstPly;
+            stats_.breakdown.opponentBest = oppBest;
+            stats_.breakdown.defenseMul = defenseMul;
+            stats_.breakdown.noise = n;
+            stats_.breakdown.total = final;
         }
-        return best;
+    };
+
+    if (!s_.enableTwoPly || stopped || stats_.resultLocked) {
+        for (const auto& m : scored) consider(m.c, m.score, 0, 0);
+        return finish(MoveSource::Heuristic, best);
     }
 
+    phaseStart = Clock::now();
+
+    CoordList oppCand(mem);
+    std::pmr::vector<ScoredMove> oppScored(mem);
+    oppCand.reserve(s_.maxCandidates);
+    oppScored.reserve(s_.maxCandidates);
+
     for (const auto& m : scored) {
+        report(MoveSource::Heuristic, 2, stats_.secondPlyMoves, scored.size(), best);
         const Coord myMove = m.c;
 
         if (!board.set(myMove, aiPlayer)) continue;
@@ -557,23 +761,32 @@ std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlaye
             ~Guard() { b.clear(c); }
         } guard{board, myMove};
 
-        std::vector<Coord> oppCand = neighborhoodCandidates(board, myMove, s_.candidateRadius, s_.maxCandidates);
+        if (useFrontier) {
+            frontierCandidatesAfter(scratch_, board, frontier, myMove, s_.candidateRadius, s_.maxCandidates, oppCand);
+        } else {
+            neighborhoodCandidates(scratch_, board, myMove, s_.candidateRadius, s_.maxCandidates, oppCand);
+        }
 
-        std::vector<ScoredMove> oppScored;
-        oppScored.reserve(oppCand.size());
+        oppScored.clear();
 
         for (const auto& oc : oppCand) {
+            if (outOfBudget()) {
+                stopped = true;
+                break;
+            }
             if (!isMoveLegalForPlayer(board, rules, opp, oc, opS.budget)) continue;
-            const long long os = evalMoveByMode(board, rules, mode, opp, oc, opS, myMove);
+            const long long os = evalMoveByMode(board, rules, patterns, mode, opp, oc, opS, myMove);
+            countEval();
+            ++stats_.secondPlyReplies;
             oppScored.push_back({oc, os});
         }
 
+        // Недосчитанный ответ соперника ничего не говорит о ходе: останавливаемся на уже сравнённых.
+        if (stopped) break;
+        ++stats_.secondPlyMoves;
+
         if (oppScored.empty()) {
-            long long final = m.score + noise(rng_);
-            if (!best || final > bestFinal) {
-                bestFinal = final;
-                best = myMove;
-            }
+            consider(myMove, m.score, 0, 0);
             continue;
         }
 
@@ -589,16 +802,87 @@ std::optional<Coord> SimpleAI::chooseMove(const GameState& state, Player aiPlaye
 
         const long long defenseMul = (mode == AiMode::Classic ? 2 : 1);
 
-        long long final = m.score - oppBest * defenseMul;
-        final += noise(rng_);
+        consider(myMove, m.score, oppBest, defenseMul, oppScored.front().c);
+    }
+
+    stats_.secondPlyTime = Clock::now() - phaseStart;
 
-        if (!best || final > bestFinal) {
-            bestFinal = final;
-            best = myMove;
-        }
+    // Лимит сработал до первого полного сравнения: лучший ход первого уровня (не обязательно первый в списке).
+    if (!best) {
+        const auto top = std::max_element(scored.begin(), scored.end(),
+                                          [](const ScoredMove& a, const ScoredMove& b) { return a.score < b.score; });
+        consider(top->c, top->score, 0, 0);
     }
+    return finish(MoveSource::Heuristic, best);
+}
+
+std::vector<SimpleAI::AnalysedMove> SimpleAI::analyse(const GameState& state, Player aiPlayer, std::size_t count,
+                                                     const SearchLimits& limits) {
+    // Один поиск: consider() складывает каждый сравнённый ход корня, лучшие count и есть ответ.
+    std::vector<AnalysedMove> lines;
+    lines_ = &lines;
+    const std::optional<Coord> best = chooseMove(state, aiPlayer, limits);
+    lines_ = nullptr;
+
+    if (!best || count == 0) return {};
+
+    // Ход из таблиц или решателей эвристика не сравнивала.
+    if (lines.empty()) return {AnalysedMove{*best, 0, 0, {*best}}};
+
+    // Равные оценки — в порядке сравнения, как и в chooseMove: первым остаётся сыгранный ход.
+    std::stable_sort(lines.begin(), lines.end(), [](const AnalysedMove& a, const AnalysedMove& b) {
+        return a.score > b.score;
+    });
+    lines.resize(std::min(count, lines.size()));
+    return lines;
+}
+
+std::vector<Coord> SimpleAI::rankMoves(const GameState& state, Player p, std::size_t count) {
+    std::vector<Coord> out;
+    if (state.isGameOver() || count == 0) return out;
 
-    return best;
+    arena_.reset();
+    std::pmr::memory_resource* mem = arena_.resource();
+
+    const IBoard& board = state.board();
+    const RuleSet& rules = state.rules();
+    const SimPlayerState self = simStatsFrom(state, p);
+    const Coord ref = state.lastMove().value_or(defaultRef(board));
+
+    SearchStats unused;
+    CoordList legal(mem);
+    rootMoves(scratch_, s_, state, board, p, self.budget, ref, legal, unused);
+
+    std::pmr::vector<std::pair<long long, Coord>> scored(mem);
+    scored.reserve(legal.size());
+    for (const auto& c : legal) {
+        scored.push_back({evalMoveByMode(board, rules, state.linePatterns(), selectMode(rules), p, c, self, ref,
+                                         state.frontier().find(c)), c});
+    }
+
+    // Равные оценки — в порядке кандидатов (по угрозе).
+    const std::size_t n = std::min(count, scored.size());
+    std::stable_sort(scored.begin(), scored.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+    out.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) out.push_back(scored[i].second);
+    return out;
+}
+
+SimpleAI::CellScore SimpleAI::scoreCell(const GameState& state, Player p, Coord c) const {
+    CellScore out;
+    const IBoard& board = state.board();
+    const RuleSet& rules = state.rules();
+    const SimPlayerState self = simStatsFrom(state, p);
+    if (p == Player::None || !isMoveLegalForPlayer(board, rules, p, c, self.budget)) return out;
+
+    // ref = c: штраф за удалённость от последнего хода обнуляется, остаётся оценка самой клетки.
+    const FrontierCell* pre = state.frontier().find(c);
+    const LinePatterns& patterns = state.linePatterns();
+    out.legal = true;
+    out.move = evalMoveByMode(board, rules, patterns, selectMode(rules), p, c, self, c, pre);
+    out.own = (pre ? pre->of(p).potential : patterns.potentialAt(board, p, c)).value;
+    out.opponent = (pre ? pre->of(other(p)).potential : patterns.potentialAt(board, other(p), c)).value;
+    return out;
 }
 
 } // namespace engine
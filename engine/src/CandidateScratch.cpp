@@ -0,0 +1,151 @@
+#include "../include/engine/CandidateScratch.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace engine {
+namespace {
+
+long long manhattan(Coord a, Coord b) {
+    return std::llabs(static_cast<long long>(a.x) - b.x) + std::llabs(static_cast<long long>(a.y) - b.y);
+}
+
+bool byRow(const Coord& a, const Coord& b) {
+    if (a.y != b.y) return a.y < b.y;
+    return a.x < b.x;
+}
+
+} // namespace
+
+void CandidateScratch::beginMarks(Coord lo, Coord hi) {
+    if (++gen_ == 0) {
+        // Переполнение поколения: старые отметки могли бы совпасть с новыми.
+        std::fill(dense_.begin(), dense_.end(), 0u);
+        for (auto& t : tiles_) t.fill(0u);
+        gen_ = 1;
+    }
+
+    denseW_ = 0;
+    denseH_ = 0;
+    if (hi.x < lo.x || hi.y < lo.y) return;
+
+    const long long w = static_cast<long long>(hi.x) - lo.x + 1;
+    const long long h = static_cast<long long>(hi.y) - lo.y + 1;
+    if (w * h > static_cast<long long>(kMaxDense)) return;
+
+    lo_ = lo;
+    denseW_ = static_cast<int>(w);
+    denseH_ = static_cast<int>(h);
+    if (dense_.size() < static_cast<std::size_t>(w * h)) dense_.resize(static_cast<std::size_t>(w * h), 0u);
+}
+
+std::uint32_t& CandidateScratch::tileStamp(Coord c) {
+    const std::uint64_t key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(c.x >> kTileBits)) << 32)
+                            | static_cast<std::uint32_t>(c.y >> kTileBits);
+    if (tiles_.empty() || key != lastTileKey_) {
+        const auto [it, inserted] = tileIndex_.try_emplace(key, static_cast<std::uint32_t>(tiles_.size()));
+        if (inserted) tiles_.emplace_back().fill(0u);
+        lastTileKey_ = key;
+        lastTile_ = it->second;
+    }
+    const int lx = c.x & (kTileSide - 1);
+    const int ly = c.y & (kTileSide - 1);
+    return tiles_[lastTile_][static_cast<std::size_t>(ly * kTileSide + lx)];
+}
+
+bool CandidateScratch::mark(Coord c) {
+    const long long dx = static_cast<long long>(c.x) - lo_.x;
+    const long long dy = static_cast<long long>(c.y) - lo_.y;
+    std::uint32_t& stamp = (dx >= 0 && dy >= 0 && dx < denseW_ && dy < denseH_)
+        ? dense_[static_cast<std::size_t>(dy * denseW_ + dx)]
+        : tileStamp(c);
+    if (stamp == gen_) return false;
+    stamp = gen_;
+    return true;
+}
+
+std::size_t CandidateScratch::sortByDistance(std::span<Coord> cells, Coord ref, std::size_t keep) {
+    const std::size_t n = cells.size();
+    if (keep == 0 || keep > n) keep = n;
+    if (n < 2) return keep;
+
+    long long minD = manhattan(cells.front(), ref);
+    long long maxD = minD;
+    for (const Coord& c : cells) {
+        const long long d = manhattan(c, ref);
+        minD = std::min(minD, d);
+        maxD = std::max(maxD, d);
+    }
+
+    // Корзины выгодны, пока диапазон расстояний сравним с числом клеток (кандидаты вокруг ref).
+    const long long range = maxD - minD + 1;
+    if (range > static_cast<long long>(4 * n + 64)) {
+        const auto keepEnd = cells.begin() + static_cast<std::ptrdiff_t>(keep);
+        std::partial_sort(cells.begin(), keepEnd, cells.end(), [&](const Coord& a, const Coord& b) {
+            const long long da = manhattan(a, ref);
+            const long long db = manhattan(b, ref);
+            if (da != db) return da < db;
+            return byRow(a, b);
+        });
+        return keep;
+    }
+
+    bucketStart_.assign(static_cast<std::size_t>(range) + 1, 0u);
+    for (const Coord& c : cells) ++bucketStart_[static_cast<std::size_t>(manhattan(c, ref) - minD) + 1];
+    for (std::size_t b = 1; b < bucketStart_.size(); ++b) bucketStart_[b] += bucketStart_[b - 1];
+
+    sorted_.resize(n);
+    for (const Coord& c : cells) {
+        sorted_[bucketStart_[static_cast<std::size_t>(manhattan(c, ref) - minD)]++] = c;
+    }
+
+    // После раскладки bucketStart_[b] указывает на конец корзины b; внутри корзины порядок по строкам.
+    std::size_t begin = 0;
+    for (std::size_t b = 0; b + 1 < bucketStart_.size() && begin < keep; ++b) {
+        const std::size_t end = bucketStart_[b];
+        std::sort(sorted_.begin() + static_cast<std::ptrdiff_t>(begin),
+                  sorted_.begin() + static_cast<std::ptrdiff_t>(end), byRow);
+        begin = end;
+    }
+
+    std::copy(sorted_.begin(), sorted_.begin() + static_cast<std::ptrdiff_t>(keep), cells.begin());
+    return keep;
+}
+
+std::span<const Coord> CandidateScratch::neighborhood(const IBoard& board,
+                                                      const std::vector<std::pair<Coord, Player>>& stones, int radius,
+                                                      Coord ref, std::size_t maxCandidates) {
+    cells_.clear();
+    if (radius < 0) radius = 0;
+    if (stones.empty()) return {};
+
+    if (board.isFinite()) {
+        beginMarks(Coord{0, 0}, Coord{board.width() - 1, board.height() - 1});
+    } else {
+        Coord lo = stones.front().first;
+        Coord hi = lo;
+        for (const auto& [s, p] : stones) {
+            (void)p;
+            lo = Coord{std::min(lo.x, s.x), std::min(lo.y, s.y)};
+            hi = Coord{std::max(hi.x, s.x), std::max(hi.y, s.y)};
+        }
+        beginMarks(Coord{lo.x - radius, lo.y - radius}, Coord{hi.x + radius, hi.y + radius});
+    }
+
+    for (const auto& [s, p] : stones) {
+        (void)p;
+        for (int dy = -radius; dy <= radius; ++dy) {
+            for (int dx = -radius; dx <= radius; ++dx) {
+                const Coord c{s.x + dx, s.y + dy};
+                if (board.isFinite() && !board.inBounds(c)) continue;
+                if (board.get(c) != Player::None) continue;
+                if (mark(c)) cells_.push_back(c);
+            }
+        }
+    }
+
+    const std::size_t kept = sortByDistance(cells_, ref, maxCandidates);
+    return std::span<const Coord>(cells_.data(), kept);
+}
+
+}
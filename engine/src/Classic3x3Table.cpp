@@ -0,0 +1,90 @@
+#include "../include/engine/Classic3x3Table.h"
+
+#include <bit>
+
+namespace engine {
+namespace {
+
+constexpr int kLineMasks[8] = {
+    0007, 0070, 0700,   // rows
+    0111, 0222, 0444,   // columns
+    0421, 0124          // diagonals
+};
+
+// Лёгкий приоритет центра, затем углов при равенстве оценок
+constexpr int kPreferOrder[9] = {4, 0,2,6,8, 1,3,5,7};
+
+constexpr int kPow3[9] = {1, 3, 9, 27, 81, 243, 729, 2187, 6561};
+
+struct Table {
+    Classic3x3Entry e[kClassic3x3Positions];
+};
+
+constexpr bool hasLine(int mask) {
+    for (const int ln : kLineMasks) {
+        if ((mask & ln) == ln) return true;
+    }
+    return false;
+}
+
+constexpr Table buildTable() {
+    Table t{};
+
+    // Добавление камня только увеличивает индекс, поэтому при обходе с конца
+    // все дочерние позиции уже посчитаны.
+    for (int idx = kClassic3x3Positions - 1; idx >= 0; --idx) {
+        int xm = 0;
+        int om = 0;
+        int rest = idx;
+        for (int i = 0; i < 9; ++i) {
+            const int d = rest % 3;
+            rest /= 3;
+            if (d == 1) xm |= 1 << i;
+            else if (d == 2) om |= 1 << i;
+        }
+
+        const int xs = std::popcount(static_cast<unsigned>(xm));
+        const int os = std::popcount(static_cast<unsigned>(om));
+        if (xs != os && xs != os + 1) continue;
+
+        const int empties = 9 - xs - os;
+        Classic3x3Entry& e = t.e[idx];
+
+        if (hasLine(xm) || hasLine(om)) {
+            e.score = static_cast<std::int8_t>(-(empties + 1));
+            continue;
+        }
+        if (empties == 0) continue;
+
+        const int toMove = (xs == os) ? 1 : 2;
+        const int occupied = xm | om;
+
+        int best = -100;
+        for (const int cell : kPreferOrder) {
+            if (occupied & (1 << cell)) continue;
+            const int s = -t.e[idx + toMove * kPow3[cell]].score;
+            if (s > best) {
+                best = s;
+                e.move = static_cast<std::uint8_t>(cell);
+            }
+        }
+        e.score = static_cast<std::int8_t>(best);
+    }
+
+    return t;
+}
+
+constexpr auto kTable = buildTable();
+
+static_assert(kTable.e[0].score == 0, "empty 3x3 board must be a draw");
+static_assert(kTable.e[0].move == 4, "centre is the preferred opening");
+
+}
+
+const Classic3x3Entry& classic3x3Lookup(int index) noexcept {
+    static constexpr Classic3x3Entry none{};
+    if (index < 0 || index >= kClassic3x3Positions) return none;
+    return kTable.e[index];
+}
+
+}
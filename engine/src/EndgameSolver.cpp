@@ -0,0 +1,530 @@
+#include "../include/engine/EndgameSolver.h"
+
+#include "../include/engine/FiniteBoard.h"
+#include "../include/engine/ScoreBounds.h"
+#include "../include/engine/Scoring.h"
+#include "../include/engine/Symmetry.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace engine {
+namespace {
+
+constexpr int kMaxCells = 255; // индекс хода хранится в uint8, 0xff = нет хода
+constexpr long long INF = EndgameSolver::kWinValue * 2;
+constexpr int kBoundsMinMoves = 3;      // у самых листьев оценка ScoreBounds дороже перебора
+constexpr std::uint32_t kBoundsWarmup = 256; // столько проверок на каждой глубине делаются всегда
+constexpr std::uint32_t kBoundsRetry = 16;   // при редких отсечениях проверяется каждый kBoundsRetry-й узел
+
+enum : std::uint8_t { BoundNone = 0, BoundExact = 1, BoundLower = 2, BoundUpper = 3 };
+
+std::uint64_t mix(std::uint64_t z) {
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+std::size_t floorPow2(std::size_t v) {
+    std::size_t p = 1;
+    while (p * 2 <= v) p <<= 1;
+    return p;
+}
+
+struct Side {
+    int lines = 0;
+    long long score = 0;
+};
+
+struct Candidate {
+    int cell = 0;
+    long long order = 0;
+    MoveDelta delta{};
+    int cost = 0;
+};
+
+long long linesScaleFor(const RuleSet& rules) {
+    return 2 * Scoring::scoreBound(rules) + 1;
+}
+
+}
+
+struct EndgameSolver::Context {
+    const RuleSet& rules;
+    int cells = 0;
+    std::vector<Coord> coords;         // клетка -> координата
+    std::vector<std::uint64_t> zobrist; // 2 ключа на клетку
+    // Для каждой симметрии правил (кроме тождественной): клетка -> образ и образ -> клетка.
+    std::vector<std::vector<std::uint8_t>> symCell;
+    std::vector<std::vector<std::uint8_t>> symInverse;
+    std::vector<std::uint64_t> symKeys; // [клетка * 2 + игрок][симметрия]: ключ образа, подряд для toggle
+    long long linesScale = 1;
+    ScoreBounds bounds;                 // копия у каждого потока: внутри буферы
+    SearchLimits limits;
+    std::uint64_t workerNodes = 0; // доля бюджета узлов на поток, 0 = без ограничения
+    std::atomic<bool> stop{false};
+
+    explicit Context(const RuleSet& r) : rules(r) {}
+
+    long long margin(const Side& me, const Side& opp) const {
+        long long m = me.score - opp.score;
+        if (rules.maximizeLines) m += static_cast<long long>(me.lines - opp.lines) * linesScale;
+        return m;
+    }
+};
+
+class EndgameSolver::Worker {
+public:
+    Worker(Context& ctx, Entry* table, std::size_t mask, const IBoard& source)
+        : ctx_(ctx), table_(table), mask_(mask), board_(source.width(), source.height()), bounds_(ctx.bounds) {
+        for (int i = 0; i < ctx_.cells; ++i) {
+            const Player p = source.get(ctx_.coords[static_cast<std::size_t>(i)]);
+            if (p == Player::None) continue;
+            (void)board_.set(ctx_.coords[static_cast<std::size_t>(i)], p);
+            toggle(i, p);
+        }
+        // Буферы по глубине выделяются заранее: ссылки на них живут через рекурсию.
+        plyMoves_.resize(static_cast<std::size_t>(ctx_.cells) + 2);
+        boundStats_.resize(static_cast<std::size_t>(ctx_.cells) + 1);
+    }
+
+    std::uint64_t nodes() const noexcept { return nodes_; }
+    std::uint64_t probes() const noexcept { return probes_; }
+    std::uint64_t hits() const noexcept { return hits_; }
+    bool aborted() const noexcept { return aborted_; }
+
+    // Ходы в порядке убывания оценки (выигрыш, блок выигрыша, прирост своих и чужих линий).
+    std::vector<Candidate>& generate(Player toMove, const Side& me, int ply) {
+        auto& out = plyMoves_[static_cast<std::size_t>(ply)];
+        out.clear();
+
+        const RuleSet& rules = ctx_.rules;
+        const bool scoreCosts = rules.moveCostsEnabled && rules.costMode == CostMode::CostFromScore;
+
+        for (int i = 0; i < ctx_.cells; ++i) {
+            const Coord c = ctx_.coords[static_cast<std::size_t>(i)];
+            if (!board_.isEmpty(c)) continue;
+
+            Candidate cand;
+            cand.cell = i;
+            cand.delta = Scoring::computeMoveDelta(board_, c, toMove, rules);
+            cand.cost = scoreCosts ? std::max(0, rules.costFunction.value(c)) : 0;
+
+            const MoveDelta block = Scoring::computeMoveDelta(board_, c, other(toMove), rules);
+
+            if (wins(cand.delta, me.score + cand.delta.scoreDelta - cand.cost)) {
+                cand.order = INF;
+            } else if (rules.classicWin && block.maxRunLen >= rules.N) {
+                cand.order = INF / 2;
+            } else {
+                cand.order = gain(cand.delta, cand.cost) + gain(block, 0);
+            }
+            out.push_back(cand);
+        }
+
+        std::stable_sort(out.begin(), out.end(), [](const Candidate& a, const Candidate& b) { return a.order > b.order; });
+        return out;
+    }
+
+    // Значение хода для ходящего (точное, если > alpha).
+    long long play(const Candidate& cand, Player toMove, const Side& me, const Side& opp, int moveCount,
+                   int ply, long long alpha, long long beta) {
+        const RuleSet& rules = ctx_.rules;
+
+        Side after = me;
+        after.lines += cand.delta.linesDelta;
+        after.score += cand.delta.scoreDelta - cand.cost;
+
+        const int emptiesAfter = ctx_.cells - moveCount - 1;
+
+        if (wins(cand.delta, after.score)) return EndgameSolver::kWinValue + emptiesAfter;
+        if (emptiesAfter == 0 || (rules.maxMoves > 0 && moveCount + 1 >= rules.maxMoves)) {
+            return ctx_.margin(after, opp);
+        }
+
+        const Coord c = ctx_.coords[static_cast<std::size_t>(cand.cell)];
+        (void)board_.set(c, toMove);
+        toggle(cand.cell, toMove);
+
+        const long long v = -search(other(toMove), opp, after, moveCount + 1, ply + 1, -beta, -alpha);
+
+        toggle(cand.cell, toMove);
+        (void)board_.clear(c);
+        return v;
+    }
+
+    int movesLeft(int moveCount) const {
+        int left = ctx_.cells - moveCount;
+        if (ctx_.rules.maxMoves > 0) left = std::min(left, ctx_.rules.maxMoves - moveCount);
+        return left;
+    }
+
+    // Диапазон значения позиции для ходящего по оценкам того, что каждый ещё может набрать (ScoreBounds).
+    std::pair<long long, long long> valueRange(Player toMove, const Side& me, const Side& opp, int moveCount) {
+        const int empties = ctx_.cells - moveCount;
+        const int left = movesLeft(moveCount);
+
+        const ScoreBounds::Reach a = bounds_.reach(board_, toMove, me.lines, me.score, left - left / 2);
+        const ScoreBounds::Reach b = bounds_.reach(board_, other(toMove), opp.lines, opp.score, left / 2);
+
+        const long long hi = a.canWin ? EndgameSolver::kWinValue + empties
+                                      : ctx_.margin(Side{a.maxLines, a.maxScore}, Side{b.minLines, b.minScore});
+        const long long lo = b.canWin ? -(EndgameSolver::kWinValue + empties)
+                                      : ctx_.margin(Side{a.minLines, a.minScore}, Side{b.maxLines, b.maxScore});
+        return {lo, hi};
+    }
+
+private:
+    Context& ctx_;
+    Entry* table_;
+    std::size_t mask_;
+    FiniteBoard board_;
+    ScoreBounds bounds_;
+    std::uint64_t hash_ = 0;
+    std::uint64_t symHash_[BoardSymmetry::kTransforms]{}; // хеши образов позиции по ctx_.symCell
+    std::uint64_t nodes_ = 0;
+    std::uint64_t probes_ = 0;
+    std::uint64_t hits_ = 0;
+    bool aborted_ = false;
+    std::vector<std::vector<Candidate>> plyMoves_;
+
+    // Доля отсечений по границам на каждом числе оставшихся ходов: где они не срабатывают, проверки реже.
+    struct BoundStats {
+        std::uint32_t calls = 0;
+        std::uint32_t cuts = 0;
+        std::uint32_t skipped = 0;
+
+        void record(bool cut) {
+            ++calls;
+            if (cut) ++cuts;
+        }
+    };
+    std::vector<BoundStats> boundStats_;
+
+    bool boundsWorthIt(int left) {
+        if (left < kBoundsMinMoves) return false;
+        BoundStats& st = boundStats_[static_cast<std::size_t>(left)];
+        if (st.calls < kBoundsWarmup || st.cuts * 4 >= st.calls) return true;
+        if (++st.skipped < kBoundsRetry) return false;
+        st.skipped = 0;
+        return true;
+    }
+
+    std::uint64_t key(int cell, Player p) const {
+        return ctx_.zobrist[static_cast<std::size_t>(cell) * 2 + (p == Player::X ? 0 : 1)];
+    }
+
+    void toggle(int cell, Player p) {
+        hash_ ^= key(cell, p);
+        const std::size_t n = ctx_.symCell.size();
+        const std::uint64_t* k = ctx_.symKeys.data() + (static_cast<std::size_t>(cell) * 2 + (p == Player::X ? 0 : 1)) * n;
+        for (std::size_t s = 0; s < n; ++s) symHash_[s] ^= k[s];
+    }
+
+    // Ключ таблицы: наименьший хеш среди симметричных вариантов; sym = номер симметрии или -1.
+    std::uint64_t canonicalKey(int& sym) const {
+        std::uint64_t h = hash_;
+        sym = -1;
+        for (std::size_t s = 0; s < ctx_.symCell.size(); ++s) {
+            if (symHash_[s] < h) {
+                h = symHash_[s];
+                sym = static_cast<int>(s);
+            }
+        }
+        return h;
+    }
+
+    bool wins(const MoveDelta& d, long long scoreAfter) const {
+        const RuleSet& rules = ctx_.rules;
+        if (rules.classicWin && d.maxRunLen >= rules.N) return true;
+        return rules.weightsEnabled && rules.targetScore > 0 && scoreAfter >= rules.targetScore;
+    }
+
+    long long gain(const MoveDelta& d, int cost) const {
+        long long g = d.scoreDelta - cost;
+        if (ctx_.rules.maximizeLines) g += static_cast<long long>(d.linesDelta) * ctx_.linesScale;
+        return g;
+    }
+
+    bool timeUp() {
+        ++nodes_;
+        if (ctx_.workerNodes > 0 && nodes_ >= ctx_.workerNodes) return true;
+        if ((nodes_ & 1023) == 0 && ctx_.limits.expired()) ctx_.stop.store(true, std::memory_order_relaxed);
+        return ctx_.stop.load(std::memory_order_relaxed);
+    }
+
+    long long search(Player toMove, const Side& me, const Side& opp, int moveCount, int ply,
+                     long long alpha, long long beta) {
+        if (aborted_ || timeUp()) {
+            aborted_ = true;
+            return 0;
+        }
+
+        const long long alpha0 = alpha;
+
+        int sym = -1;
+        const std::uint64_t key = canonicalKey(sym);
+
+        Entry& e = table_[key & mask_];
+        int ttBest = -1;
+        ++probes_;
+        if (e.bound != BoundNone && e.key == key) {
+            ++hits_;
+            // Лучший ход хранится в системе канонической позиции.
+            if (e.best != 0xff) ttBest = sym < 0 ? e.best : ctx_.symInverse[static_cast<std::size_t>(sym)][e.best];
+            if (e.bound == BoundExact) return e.value;
+            if (e.bound == BoundLower) alpha = std::max(alpha, e.value);
+            if (e.bound == BoundUpper) beta = std::min(beta, e.value);
+            if (alpha >= beta) return e.value;
+        }
+
+        // Ветка, итог которой уже не выходит за окно, не перебирается.
+        const int left = movesLeft(moveCount);
+        if (boundsWorthIt(left)) {
+            const auto [lo, hi] = valueRange(toMove, me, opp, moveCount);
+            const bool cut = hi <= alpha || lo >= beta || lo == hi;
+            boundStats_[static_cast<std::size_t>(left)].record(cut);
+            if (hi <= alpha) return hi;
+            if (cut) return lo;
+        }
+
+        auto& moves = generate(toMove, me, ply);
+        if (ttBest >= 0) {
+            auto it = std::find_if(moves.begin(), moves.end(), [&](const Candidate& m) { return m.cell == ttBest; });
+            if (it != moves.end()) std::rotate(moves.begin(), it, it + 1);
+        }
+
+        long long best = -INF;
+        int bestCell = -1;
+        for (std::size_t i = 0; i < moves.size(); ++i) {
+            const Candidate cand = moves[i];
+            const long long v = play(cand, toMove, me, opp, moveCount, ply, alpha, beta);
+            if (aborted_) return 0;
+
+            if (v > best) {
+                best = v;
+                bestCell = cand.cell;
+            }
+            if (v > alpha) alpha = v;
+            if (alpha >= beta) break;
+        }
+
+        Entry& slot = table_[key & mask_];
+        slot.key = key;
+        slot.value = best;
+        if (bestCell < 0) {
+            slot.best = 0xff;
+        } else {
+            slot.best = sym < 0 ? static_cast<std::uint8_t>(bestCell)
+                                : ctx_.symCell[static_cast<std::size_t>(sym)][static_cast<std::size_t>(bestCell)];
+        }
+        slot.bound = (best <= alpha0) ? BoundUpper : (best >= beta ? BoundLower : BoundExact);
+        return best;
+    }
+};
+
+EndgameSolver::EndgameSolver() : EndgameSolver(Settings{}) {}
+
+EndgameSolver::EndgameSolver(Settings s) : s_(s) {}
+
+bool EndgameSolver::supports(const RuleSet& rules, const IBoard& board) {
+    if (!board.isFinite()) return false;
+    if (rules.moveCostsEnabled && rules.costMode == CostMode::CostFromBudget) return false;
+
+    const long long cells = static_cast<long long>(board.width()) * static_cast<long long>(board.height());
+    if (cells <= 0 || cells > kMaxCells) return false;
+
+    // Линий у игрока не больше 4 на клетку (с подотрезками тоже: каждое окно начинается в своей клетке).
+    const long long bound = Scoring::scoreBound(rules);
+    const long long scale = linesScaleFor(rules);
+    return bound < kWinValue / 8 && scale < kWinValue / (8 * 4 * cells);
+}
+
+int EndgameSolver::remainingMoves(const GameState& state) {
+    const IBoard& board = state.board();
+    if (!board.isFinite()) return std::numeric_limits<int>::max();
+
+    int left = board.width() * board.height() - state.moveCount();
+    if (state.rules().maxMoves > 0) left = std::min(left, state.rules().maxMoves - state.moveCount());
+    return std::max(0, left);
+}
+
+int EndgameSolver::emptyCells(const GameState& state) {
+    const IBoard& board = state.board();
+    if (!board.isFinite()) return std::numeric_limits<int>::max();
+    return std::max(0, board.width() * board.height() - state.moveCount());
+}
+
+EndgameSolver::Result EndgameSolver::solve(const GameState& state, Player aiPlayer, const SearchLimits& limits) {
+    Result result;
+    if (state.isGameOver() || state.currentPlayer() != aiPlayer) return result;
+
+    const RuleSet& rules = state.rules();
+    const IBoard& board = state.board();
+    if (!supports(rules, board)) return result;
+    if (static_cast<int>(board.occupied().size()) != state.moveCount()) return result;
+
+    Context ctx(rules);
+    ctx.cells = board.width() * board.height();
+    ctx.linesScale = linesScaleFor(rules);
+    ctx.bounds = ScoreBounds(rules, board.width(), board.height());
+    ctx.limits = limits;
+
+    // Клетки ближе к центру идут первыми: при равных оценках это лучший порядок.
+    ctx.coords.reserve(static_cast<std::size_t>(ctx.cells));
+    for (int y = 0; y < board.height(); ++y) {
+        for (int x = 0; x < board.width(); ++x) ctx.coords.push_back(Coord{x, y});
+    }
+    const int cx2 = board.width() - 1;
+    const int cy2 = board.height() - 1;
+    std::stable_sort(ctx.coords.begin(), ctx.coords.end(), [&](const Coord& a, const Coord& b) {
+        const int da = std::abs(2 * a.x - cx2) + std::abs(2 * a.y - cy2);
+        const int db = std::abs(2 * b.x - cx2) + std::abs(2 * b.y - cy2);
+        return da < db;
+    });
+
+    // Ключи зависят от координаты, а не от порядка обхода: таблица переживает смену позиции.
+    ctx.zobrist.resize(static_cast<std::size_t>(ctx.cells) * 2);
+    for (int i = 0; i < ctx.cells; ++i) {
+        const Coord c = ctx.coords[static_cast<std::size_t>(i)];
+        const std::uint64_t base = static_cast<std::uint64_t>(c.y * board.width() + c.x) * 2;
+        ctx.zobrist[static_cast<std::size_t>(i) * 2] = mix(base + 1);
+        ctx.zobrist[static_cast<std::size_t>(i) * 2 + 1] = mix(base + 2);
+    }
+
+    // Симметрии правил: позиции-образы делят одну запись таблицы.
+    const BoardSymmetry symmetry = BoardSymmetry::detect(rules, board.width(), board.height());
+    std::vector<int> cellOf(static_cast<std::size_t>(ctx.cells));
+    for (int i = 0; i < ctx.cells; ++i) {
+        const Coord c = ctx.coords[static_cast<std::size_t>(i)];
+        cellOf[static_cast<std::size_t>(c.y * board.width() + c.x)] = i;
+    }
+    for (int t = 1; t < BoardSymmetry::kTransforms; ++t) {
+        if (!symmetry.has(t)) continue;
+        std::vector<std::uint8_t> fwd(static_cast<std::size_t>(ctx.cells));
+        std::vector<std::uint8_t> inv(static_cast<std::size_t>(ctx.cells));
+        for (int i = 0; i < ctx.cells; ++i) {
+            const Coord q = symmetry.apply(t, ctx.coords[static_cast<std::size_t>(i)]);
+            const int j = cellOf[static_cast<std::size_t>(q.y * board.width() + q.x)];
+            fwd[static_cast<std::size_t>(i)] = static_cast<std::uint8_t>(j);
+            inv[static_cast<std::size_t>(j)] = static_cast<std::uint8_t>(i);
+        }
+        ctx.symCell.push_back(std::move(fwd));
+        ctx.symInverse.push_back(std::move(inv));
+    }
+    const std::size_t syms = ctx.symCell.size();
+    ctx.symKeys.resize(static_cast<std::size_t>(ctx.cells) * 2 * syms);
+    for (int i = 0; i < ctx.cells; ++i) {
+        for (std::size_t s = 0; s < syms; ++s) {
+            const std::size_t j = ctx.symCell[s][static_cast<std::size_t>(i)];
+            ctx.symKeys[(static_cast<std::size_t>(i) * 2) * syms + s] = ctx.zobrist[j * 2];
+            ctx.symKeys[(static_cast<std::size_t>(i) * 2 + 1) * syms + s] = ctx.zobrist[j * 2 + 1];
+        }
+    }
+
+    unsigned threads = s_.threads ? s_.threads : std::max(1u, std::thread::hardware_concurrency());
+    if (limits.maxNodes > 0) ctx.workerNodes = std::max<std::uint64_t>(1, limits.maxNodes / threads);
+
+    const std::size_t segment = floorPow2(std::max<std::size_t>(s_.tableEntries / threads, 1024));
+    const std::uint64_t rulesKey = rules.fingerprint() ^ mix(static_cast<std::uint64_t>(ctx.cells));
+    if (table_.size() != segment * threads || tableRules_ != rulesKey) {
+        table_.assign(segment * threads, Entry{});
+        tableRules_ = rulesKey;
+    }
+
+    const Side me{state.stats(aiPlayer).lines, state.stats(aiPlayer).score};
+    const Side opp{state.stats(other(aiPlayer)).lines, state.stats(other(aiPlayer)).score};
+    const int moveCount = state.moveCount();
+
+    std::vector<Worker> workers;
+    workers.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back(ctx, table_.data() + t * segment, segment - 1, board);
+    }
+
+    std::vector<Candidate> roots = workers.front().generate(aiPlayer, me, 0);
+    if (roots.empty()) return result;
+
+    // Исход уже не зависит от игры: любой ход даёт то же значение.
+    const auto [lo, hi] = workers.front().valueRange(aiPlayer, me, opp, moveCount);
+    if (lo == hi) {
+        result.move = ctx.coords[static_cast<std::size_t>(roots.front().cell)];
+        result.value = lo;
+        result.exact = true;
+        result.rootsFinished = result.rootsTotal = roots.size();
+        return result;
+    }
+
+    // Ходы, симметричные уже взятому относительно текущей позиции, дают ту же оценку.
+    const std::uint8_t stab = symmetry.stabilizer(board);
+    if (stab != 1) {
+        std::vector<bool> covered(static_cast<std::size_t>(ctx.cells), false);
+        std::erase_if(roots, [&](const Candidate& m) {
+            if (covered[static_cast<std::size_t>(m.cell)]) return true;
+            const Coord c = ctx.coords[static_cast<std::size_t>(m.cell)];
+            for (int t = 0; t < BoardSymmetry::kTransforms; ++t) {
+                if (!((stab >> t) & 1u)) continue;
+                const Coord q = symmetry.apply(t, c);
+                covered[static_cast<std::size_t>(cellOf[static_cast<std::size_t>(q.y * board.width() + q.x)])] = true;
+            }
+            return false;
+        });
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<long long> sharedAlpha{-INF};
+    std::mutex mutex;
+    std::size_t finished = 0;
+    std::size_t bestIndex = roots.size();
+
+    auto run = [&](Worker& w) {
+        for (;;) {
+            const std::size_t i = next.fetch_add(1);
+            if (i >= roots.size() || ctx.stop.load()) return;
+
+            // Окно (alpha, +inf): хуже текущего лучшего — только верхняя оценка, лучше — точное значение.
+            const long long alpha = sharedAlpha.load();
+            const long long v = w.play(roots[i], aiPlayer, me, opp, moveCount, 1, alpha, INF);
+            if (w.aborted()) return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            ++finished;
+            const bool exactValue = v > alpha;
+            if (bestIndex == roots.size() || v > result.value || (exactValue && v == result.value && i < bestIndex)) {
+                bestIndex = i;
+                result.value = v;
+                result.move = ctx.coords[static_cast<std::size_t>(roots[i].cell)];
+                if (v > sharedAlpha.load()) sharedAlpha.store(v);
+            }
+        }
+    };
+
+    if (threads == 1) {
+        run(workers.front());
+    } else {
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        for (unsigned t = 1; t < threads; ++t) pool.emplace_back(run, std::ref(workers[t]));
+        run(workers.front());
+        for (auto& th : pool) th.join();
+    }
+
+    for (const auto& w : workers) {
+        result.nodes += w.nodes();
+        result.tableProbes += w.probes();
+        result.tableHits += w.hits();
+    }
+    result.exact = finished == roots.size();
+    result.rootsFinished = finished;
+    result.rootsTotal = roots.size();
+    return result;
+}
+
+}
@@ -63,4 +63,8 @@ namespace engine {
         return out;
     }
 
+    std::unique_ptr<IBoard> FiniteBoard::clone() const {
+        return std::make_unique<FiniteBoard>(*this);
+    }
+
 }
\ No newline at end of file
@@ -0,0 +1,104 @@
+#include "../include/engine/FrontierMaps.h"
+
+namespace engine {
+
+void FrontierMaps::reset(int radius) {
+    radius_ = radius > 0 ? radius : 0;
+    cells_.clear();
+    near_.clear();
+}
+
+const FrontierCell* FrontierMaps::find(Coord c) const {
+    const auto it = cells_.find(c);
+    return it == cells_.end() ? nullptr : &it->second;
+}
+
+void FrontierMaps::compute(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns,
+                           FrontierCell& out) const {
+    for (const Player p : {Player::X, Player::O}) {
+        CellEval& e = out.eval[playerIndex(p)];
+        e.delta = Scoring::computeMoveDelta(board, c, p, rules);
+        e.potential = patterns.potentialAt(board, p, c);
+    }
+}
+
+void FrontierMaps::rebuild(const IBoard& board, const RuleSet& rules, const LinePatterns& patterns) {
+    cells_.clear();
+    near_.clear();
+    if (!enabled()) return;
+
+    for (const auto& [s, p] : board.occupied()) {
+        (void)p;
+        for (int dy = -radius_; dy <= radius_; ++dy) {
+            for (int dx = -radius_; dx <= radius_; ++dx) {
+                const Coord t{s.x + dx, s.y + dy};
+                if (board.inBounds(t)) ++near_[t];
+            }
+        }
+    }
+
+    for (const auto& [t, count] : near_) {
+        (void)count;
+        if (board.isEmpty(t)) compute(board, t, rules, patterns, cells_[t]);
+    }
+}
+
+// Пересчёт клеток фронта на 8 лучах из c: за одноцветной серией до первой пустой клетки.
+void FrontierMaps::refreshLines(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns) {
+    const int dirs[8][2] = {{1,0}, {-1,0}, {0,1}, {0,-1}, {1,1}, {-1,-1}, {1,-1}, {-1,1}};
+
+    for (const auto& d : dirs) {
+        Player run = Player::None;
+        Coord t{c.x + d[0], c.y + d[1]};
+        while (board.inBounds(t)) {
+            const Player q = board.get(t);
+            if (q == Player::None) {
+                auto it = cells_.find(t);
+                if (it != cells_.end()) compute(board, t, rules, patterns, it->second);
+                break;
+            }
+            if (run == Player::None) run = q;
+            else if (q != run) break;
+            t.x += d[0];
+            t.y += d[1];
+        }
+    }
+}
+
+void FrontierMaps::onPlaced(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns) {
+    if (!enabled()) return;
+
+    cells_.erase(c);
+    refreshLines(board, c, rules, patterns);
+
+    for (int dy = -radius_; dy <= radius_; ++dy) {
+        for (int dx = -radius_; dx <= radius_; ++dx) {
+            const Coord t{c.x + dx, c.y + dy};
+            if (!board.inBounds(t)) continue;
+            ++near_[t];
+            if (board.isEmpty(t) && cells_.find(t) == cells_.end()) compute(board, t, rules, patterns, cells_[t]);
+        }
+    }
+}
+
+void FrontierMaps::onRemoved(const IBoard& board, Coord c, const RuleSet& rules, const LinePatterns& patterns) {
+    if (!enabled()) return;
+
+    for (int dy = -radius_; dy <= radius_; ++dy) {
+        for (int dx = -radius_; dx <= radius_; ++dx) {
+            const Coord t{c.x + dx, c.y + dy};
+            auto it = near_.find(t);
+            if (it == near_.end()) continue;
+            if (--it->second == 0) {
+                near_.erase(it);
+                cells_.erase(t);
+            }
+        }
+    }
+
+    refreshLines(board, c, rules, patterns);
+
+    if (near_.find(c) != near_.end()) compute(board, c, rules, patterns, cells_[c]);
+}
+
+}
@@ -7,10 +7,17 @@
 #include <algorithm>
 #include <cstdlib>
 #include <stdexcept>
-#include <unordered_set>
 
 namespace engine {
 
+namespace {
+
+bool sameStats(const PlayerStats& a, const PlayerStats& b) {
+    return a.score == b.score && a.lines == b.lines && a.budget == b.budget;
+}
+
+}
+
 GameState::GameState() {
     RuleSet rules;
     newGame(rules, createBoard(rules));
@@ -20,6 +27,41 @@ GameState::GameState(RuleSet rules, std::unique_ptr<IBoard> board) {
     newGame(std::move(rules), std::move(board));
 }
 
+GameState::GameState(const GameState& other)
+    : rules_(other.rules_),
+      board_(other.board_->clone()),
+      patterns_(other.patterns_),
+      symmetry_(other.symmetry_),
+      frontier_(other.frontier_),
+      frontierRadius_(other.frontierRadius_),
+      current_(other.current_),
+      moveCount_(other.moveCount_),
+      stats_{other.stats_[0], other.stats_[1]},
+      result_(other.result_),
+      reason_(other.reason_),
+      lastMove_(other.lastMove_),
+      lastMoveCost_(other.lastMoveCost_),
+      undoStack_(other.undoStack_),
+      redoStack_(other.redoStack_),
+      changeSeq_(other.changeSeq_) {}
+
+GameState& GameState::operator=(const GameState& other) {
+    if (this == &other) return *this;
+
+    // Подписчики остаются у этого объекта, нумерация — тоже его; для них позиция заменена целиком.
+    auto listeners = std::move(listeners_);
+    const int nextId = nextListenerId_;
+    const std::uint64_t seq = changeSeq_;
+    *this = GameState(other);
+    listeners_ = std::move(listeners);
+    nextListenerId_ = nextId;
+    changeSeq_ = seq;
+
+    beginChanges();
+    endChanges(true);
+    return *this;
+}
+
 std::unique_ptr<IBoard> GameState::createBoard(const RuleSet& rules) {
     if (rules.topology == BoardTopology::Finite) {
         return std::make_unique<FiniteBoard>(rules.width, rules.height);
@@ -31,10 +73,15 @@ void GameState::newGame(RuleSet rules, std::unique_ptr<IBoard> board) {
     rules_ = std::move(rules);
     rules_.validateAndFix();
 
+    if (patterns_.N() != rules_.N) {
+        patterns_ = LinePatterns(rules_.N);
+    }
+
     board_ = std::move(board);
     if (!board_) {
         board_ = createBoard(rules_);
     }
+    symmetry_ = BoardSymmetry::detect(rules_, board_->width(), board_->height());
 
     current_ = Player::X;
     moveCount_ = 0;
@@ -59,6 +106,18 @@ void GameState::newGame(RuleSet rules, std::unique_ptr<IBoard> board) {
 
     undoStack_.clear();
     redoStack_.clear();
+
+    frontier_.reset(frontierRadius_);
+    frontier_.rebuild(*board_, rules_, patterns_);
+
+    beginChanges();
+    endChanges(true);
+}
+
+void GameState::setFrontierRadius(int radius) {
+    frontierRadius_ = radius;
+    frontier_.reset(frontierRadius_);
+    frontier_.rebuild(*board_, rules_, patterns_);
 }
 
 const PlayerStats& GameState::stats(Player p) const {
@@ -215,6 +274,10 @@ MoveOutcome GameState::tryMakeMove(Coord c) {
         return out;
     }
 
+    beginChanges();
+    noteCell(c, current_, Player::None);
+    frontier_.onPlaced(*board_, c, rules_, patterns_);
+
     PlayerStats& s = stats(current_);
     s.lines += delta.linesDelta;
     s.score += delta.scoreDelta;
@@ -242,22 +305,38 @@ MoveOutcome GameState::tryMakeMove(Coord c) {
 
     undoStack_.push_back(rec);
     redoStack_.clear();
+    endChanges();
 
     out.ok = true;
     out.message = "OK";
     return out;
 }
 
+std::size_t GameState::playMoves(const std::vector<Coord>& moves) {
+    std::size_t played = 0;
+    beginChanges();
+    for (const Coord& c : moves) {
+        if (!tryMakeMove(c).ok) break;
+        ++played;
+    }
+    endChanges();
+    return played;
+}
+
 bool GameState::undo() {
     if (undoStack_.empty()) return false;
 
     MoveRecord rec = undoStack_.back();
     undoStack_.pop_back();
 
+    beginChanges();
     board_->clear(rec.move.coord);
+    noteCell(rec.move.coord, Player::None, rec.move.player);
+    frontier_.onRemoved(*board_, rec.move.coord, rules_, patterns_);
     restoreSnapshot(rec.before);
 
     redoStack_.push_back(rec);
+    endChanges();
     return true;
 }
 
@@ -267,13 +346,74 @@ bool GameState::redo() {
     MoveRecord rec = redoStack_.back();
     redoStack_.pop_back();
 
+    beginChanges();
     board_->set(rec.move.coord, rec.move.player);
+    noteCell(rec.move.coord, rec.move.player, Player::None);
+    frontier_.onPlaced(*board_, rec.move.coord, rules_, patterns_);
     restoreSnapshot(rec.after);
 
     undoStack_.push_back(rec);
+    endChanges();
     return true;
 }
 
+bool GameState::seek(int targetMoveCount) {
+    const int start = moveCount_;
+    beginChanges();
+    while (moveCount_ > targetMoveCount && undo()) {}
+    while (moveCount_ < targetMoveCount && redo()) {}
+    endChanges();
+    return moveCount_ != start;
+}
+
+int GameState::subscribe(ChangeListener listener) {
+    const int id = nextListenerId_++;
+    listeners_.emplace_back(id, std::move(listener));
+    return id;
+}
+
+void GameState::unsubscribe(int id) {
+    std::erase_if(listeners_, [id](const auto& l) { return l.first == id; });
+}
+
+void GameState::beginChanges() {
+    if (changeDepth_++ == 0) changeBefore_ = makeSnapshot();
+}
+
+void GameState::noteCell(Coord c, Player now, Player before) {
+    pending_.cells.push_back(CellChange{c, now, before});
+}
+
+void GameState::endChanges(bool reset) {
+    if (--changeDepth_ > 0) return;
+
+    const bool statsChanged = reset || !sameStats(stats_[0], changeBefore_.statsX) || !sameStats(stats_[1], changeBefore_.statsO);
+    const bool resultChanged = reset || result_ != changeBefore_.result || reason_ != changeBefore_.reason;
+    if (!reset && pending_.cells.empty() && !statsChanged && !resultChanged) return; // seek на месте и т.п.
+
+    ++changeSeq_;
+    if (listeners_.empty()) {
+        pending_.cells.clear(); // без подписчиков пачка не собирается, буфер переиспользуется
+        return;
+    }
+
+    ChangeBatch batch = std::move(pending_);
+    pending_ = ChangeBatch{};
+    batch.seq = changeSeq_;
+    batch.reset = reset;
+    if (reset) {
+        // Позиция заменена целиком: пачка перечисляет её камни, чтобы подписчику не нужно было перечитывать доску.
+        batch.cells.clear();
+        for (const auto& [c, p] : board_->occupied()) batch.cells.push_back(CellChange{c, p, Player::None});
+    }
+    batch.statsChanged = statsChanged;
+    batch.resultChanged = resultChanged;
+
+    // Копия списка: подписчик может отписаться (или сделать ход) прямо из обработчика.
+    const auto listeners = listeners_;
+    for (const auto& [id, listener] : listeners) listener(batch);
+}
+
 void GameState::evaluateEndOfGame(Player lastMover, int maxRunLenAfterMove) {
     if (rules_.classicWin && maxRunLenAfterMove >= rules_.N) {
         result_ = (lastMover == Player::X) ? GameResult::WinX : GameResult::WinO;
@@ -344,6 +484,13 @@ void GameState::finishByComparison(EndReason why) {
 }
 
 std::vector<Coord> GameState::generateCandidateMoves(int radius, std::size_t maxCandidates) const {
+    // Буфер на поток: прогретый, он не выделяет память, а константная партия остаётся без общего состояния.
+    thread_local CandidateScratch scratch;
+    return generateCandidateMoves(radius, maxCandidates, scratch);
+}
+
+std::vector<Coord> GameState::generateCandidateMoves(int radius, std::size_t maxCandidates,
+                                                     CandidateScratch& scratch) const {
     std::vector<Coord> out;
     if (radius < 0) radius = 0;
 
@@ -357,35 +504,9 @@ std::vector<Coord> GameState::generateCandidateMoves(int radius, std::size_t max
         return out;
     }
 
-    std::unordered_set<Coord, CoordHash> set;
-    set.reserve(std::min<std::size_t>(maxCandidates * 2, 4096));
-
-    for (const auto& [cell, p] : occ) {
-        (void)p;
-        for (int dy = -radius; dy <= radius; ++dy) {
-            for (int dx = -radius; dx <= radius; ++dx) {
-                Coord c{cell.x + dx, cell.y + dy};
-                if (board_->isFinite() && !board_->inBounds(c)) continue;
-                if (!board_->isEmpty(c)) continue;
-                set.insert(c);
-            }
-        }
-    }
-
-    out.assign(set.begin(), set.end());
-
     Coord ref = lastMove_.value_or(Coord{0, 0});
-    std::sort(out.begin(), out.end(), [&](const Coord& a, const Coord& b) {
-        const long long da = std::llabs(static_cast<long long>(a.x) - ref.x) + std::llabs(static_cast<long long>(a.y) - ref.y);
-        const long long db = std::llabs(static_cast<long long>(b.x) - ref.x) + std::llabs(static_cast<long long>(b.y) - ref.y);
-        if (da != db) return da < db;
-        if (a.y != b.y) return a.y < b.y;
-        return a.x < b.x;
-    });
-
-    if (maxCandidates > 0 && out.size() > maxCandidates) {
-        out.resize(maxCandidates);
-    }
+    const auto cells = scratch.neighborhood(*board_, occ, radius, ref, maxCandidates);
+    out.assign(cells.begin(), cells.end());
     return out;
 }
 
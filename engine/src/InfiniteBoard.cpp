@@ -34,5 +34,9 @@ namespace engine {
         return out;
     }
 
+    std::unique_ptr<IBoard> InfiniteBoard::clone() const {
+        return std::make_unique<InfiniteBoard>(*this);
+    }
+
 }
 
@@ -0,0 +1,131 @@
+#include "../include/engine/LinePatterns.h"
+
+#include <algorithm>
+
+namespace engine {
+namespace {
+
+constexpr std::uint8_t kOpenBit = 0x80;
+constexpr std::uint8_t kRunMask = 0x7f;
+
+enum : unsigned { CellEmpty = 0, CellOwn = 1, CellBlocked = 2 };
+
+}
+
+LinePatterns::LinePatterns(int N) : N_(std::max(1, N)), window_(N_) {
+    if (N_ > kMaxTableN) return;
+
+    const std::size_t patterns = std::size_t{1} << (2 * window_);
+    side_.resize(patterns);
+    for (std::size_t pat = 0; pat < patterns; ++pat) {
+        int run = 0;
+        while (run < window_ && ((pat >> (2 * run)) & 3u) == CellOwn) ++run;
+        const bool open = run < window_ && ((pat >> (2 * run)) & 3u) == CellEmpty;
+        side_[pat] = static_cast<std::uint8_t>(run | (open ? kOpenBit : 0));
+    }
+
+    const std::size_t runs = static_cast<std::size_t>(window_) + 1;
+    dir_.resize(runs * runs * 4);
+    for (std::size_t l = 0; l < runs; ++l) {
+        for (std::size_t r = 0; r < runs; ++r) {
+            for (std::size_t ol = 0; ol < 2; ++ol) {
+                for (std::size_t orr = 0; orr < 2; ++orr) {
+                    Direction& d = dir_[((l * runs + r) * 2 + ol) * 2 + orr];
+                    d.len = static_cast<int>(l + 1 + r);
+                    d.openEnds = static_cast<std::uint8_t>(ol + orr);
+                    d.canWin = d.len >= N_;
+                    d.value = directionValue(d.len, d.openEnds, N_);
+                }
+            }
+        }
+    }
+}
+
+long long LinePatterns::directionValue(int len, int openEnds, int N) {
+    if (len <= 0) return 0;
+    if (len >= N) return 1'000'000'000'000LL;
+
+    const long long l = static_cast<long long>(len);
+    const long long base = l * l * l * l; // l^4
+
+    const long long oe = (openEnds == 2 ? 10 : (openEnds == 1 ? 3 : 1));
+
+    long long bonus = 1;
+    if (N >= 2) {
+        if (len == N - 1) bonus = 2000;
+        else if (len == N - 2) bonus = 200;
+        else if (len == N - 3) bonus = 40;
+    }
+    return base * oe * bonus;
+}
+
+LinePatterns::Side LinePatterns::readSide(const IBoard& board, Player p, Coord c, int dx, int dy) const {
+    Side side;
+    Coord t{c.x + dx, c.y + dy};
+
+    if (side_.empty()) {
+        while (side.run < window_ && board.inBounds(t) && board.get(t) == p) {
+            ++side.run;
+            t.x += dx;
+            t.y += dy;
+        }
+        side.open = side.run < window_ && board.inBounds(t) && board.get(t) == Player::None;
+        return side;
+    }
+
+    // Читаем только до первой не своей клетки: остаток окна на результат не влияет.
+    unsigned pattern = 0;
+    for (int k = 0; k < window_; ++k, t.x += dx, t.y += dy) {
+        const Player q = board.inBounds(t) ? board.get(t) : other(p);
+        const unsigned code = (q == p) ? CellOwn : (q == Player::None ? CellEmpty : CellBlocked);
+        pattern |= code << (2 * k);
+        if (code != CellOwn) break;
+    }
+
+    const std::uint8_t packed = side_[pattern];
+    side.run = packed & kRunMask;
+    side.open = (packed & kOpenBit) != 0;
+    return side;
+}
+
+LinePatterns::Direction LinePatterns::direction(Side left, Side right) const {
+    if (dir_.empty()) {
+        Direction d;
+        d.len = left.run + 1 + right.run;
+        d.openEnds = static_cast<std::uint8_t>((left.open ? 1 : 0) + (right.open ? 1 : 0));
+        d.canWin = d.len >= N_;
+        d.value = directionValue(d.len, d.openEnds, N_);
+        return d;
+    }
+
+    const std::size_t runs = static_cast<std::size_t>(window_) + 1;
+    const std::size_t l = static_cast<std::size_t>(left.run);
+    const std::size_t r = static_cast<std::size_t>(right.run);
+    return dir_[((l * runs + r) * 2 + (left.open ? 1 : 0)) * 2 + (right.open ? 1 : 0)];
+}
+
+LinePotential LinePatterns::potentialAt(const IBoard& board, Player p, Coord c) const {
+    LinePotential pot;
+
+    struct Dir { int dx; int dy; };
+    const Dir dirs[4] = {{1,0}, {0,1}, {1,1}, {1,-1}};
+
+    for (const auto& d : dirs) {
+        const Direction info = direction(readSide(board, p, c, -d.dx, -d.dy), readSide(board, p, c, d.dx, d.dy));
+
+        pot.canWin = pot.canWin || info.canWin;
+
+        if (info.len > pot.bestLen) {
+            pot.bestLen = info.len;
+            pot.bestOpenEnds = info.openEnds;
+        } else if (info.len == pot.bestLen && info.openEnds > pot.bestOpenEnds) {
+            pot.bestOpenEnds = info.openEnds;
+        }
+
+        pot.value += info.value;
+    }
+
+    return pot;
+}
+
+}
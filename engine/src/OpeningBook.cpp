@@ -0,0 +1,116 @@
+#include "../include/engine/OpeningBook.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace engine {
+namespace {
+
+constexpr char kMagic[8] = {'A', 'T', 'T', 'T', 'O', 'B', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+// Ход O в той же расстановке — другая позиция.
+constexpr std::uint64_t kSideToMoveSalt = 0x9e3779b97f4a7c15ULL;
+
+bool fail(std::string* error, std::string msg) {
+    if (error) *error = std::move(msg);
+    return false;
+}
+
+}
+
+std::uint64_t OpeningBook::positionKey(const GameState& state, int* transform) {
+    const std::uint64_t h = state.symmetry().canonicalHash(state.board(), transform);
+    return state.currentPlayer() == Player::O ? h ^ kSideToMoveSalt : h;
+}
+
+OpeningBook::Entry OpeningBook::makeEntry(const GameState& state, Coord move) {
+    int t = 0;
+    Entry e;
+    e.key = positionKey(state, &t);
+    const Coord c = state.symmetry().apply(t, move);
+    e.x = c.x;
+    e.y = c.y;
+    return e;
+}
+
+bool OpeningBook::write(const RuleSet& rules, std::vector<Entry> entries, int maxPly, const std::string& path,
+                        std::string* error) {
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key < b.key; });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.key == b.key; }),
+                  entries.end());
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.maxPly = static_cast<std::uint32_t>(std::max(maxPly, 0));
+    header.width = rules.topology == BoardTopology::Finite ? rules.width : 0;
+    header.height = rules.topology == BoardTopology::Finite ? rules.height : 0;
+    header.rulesFingerprint = rules.fingerprint();
+    header.entryCount = entries.size();
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return fail(error, "cannot open " + path + " for writing");
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(entries.data()), static_cast<std::streamsize>(entries.size() * sizeof(Entry)));
+    if (!out) return fail(error, "failed to write " + path);
+
+    return true;
+}
+
+bool OpeningBook::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+
+    if (file_.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header_, file_.data(), sizeof(Header));
+
+    // Только проверка размера: записи читаются прямо из отображения.
+    const bool valid = std::memcmp(header_.magic, kMagic, sizeof(kMagic)) == 0
+                    && header_.version == kVersion
+                    && header_.width >= 0 && header_.height >= 0
+                    && file_.size() == sizeof(Header) + header_.entryCount * sizeof(Entry);
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const Entry*>(file_.data() + sizeof(Header));
+    return true;
+}
+
+void OpeningBook::close() noexcept {
+    file_.close();
+    header_ = Header{};
+    entries_ = nullptr;
+}
+
+bool OpeningBook::matches(const RuleSet& rules) const noexcept {
+    if (!isOpen()) return false;
+    const bool finite = rules.topology == BoardTopology::Finite;
+    if (finite != (header_.width > 0)) return false;
+    if (finite && (rules.width != header_.width || rules.height != header_.height)) return false;
+    return rules.fingerprint() == header_.rulesFingerprint;
+}
+
+std::optional<Coord> OpeningBook::probe(const GameState& state) const {
+    if (!matches(state.rules())) return std::nullopt;
+    if (state.moveCount() > static_cast<int>(header_.maxPly)) return std::nullopt;
+
+    int t = 0;
+    const std::uint64_t key = positionKey(state, &t);
+    const Entry* end = entries_ + header_.entryCount;
+    const Entry* it = std::lower_bound(entries_, end, key, [](const Entry& e, std::uint64_t k) { return e.key < k; });
+    if (it == end || it->key != key) return std::nullopt;
+
+    const Coord mv = state.symmetry().apply(BoardSymmetry::inverse(t), Coord{it->x, it->y});
+    if (!state.isMoveLegal(mv)) return std::nullopt;
+    return mv;
+}
+
+}
@@ -0,0 +1,85 @@
+#include "../include/engine/OverlayBoard.h"
+
+#include "../include/engine/FiniteBoard.h"
+#include "../include/engine/InfiniteBoard.h"
+
+#include <algorithm>
+
+namespace engine {
+
+const std::pair<Coord, Player>* OverlayBoard::findChange(Coord c) const noexcept {
+    // Изменений единицы (глубина поиска), линейный проход быстрее любой хеш-таблицы.
+    for (const auto& ch : changes_) {
+        if (ch.first == c) return &ch;
+    }
+    return nullptr;
+}
+
+void OverlayBoard::record(Coord c, Player p) {
+    auto it = std::find_if(changes_.begin(), changes_.end(), [&](const auto& ch) { return ch.first == c; });
+
+    // Клетка вернулась к состоянию базы: запись больше не нужна.
+    if (base_->get(c) == p) {
+        if (it != changes_.end()) {
+            *it = changes_.back();
+            changes_.pop_back();
+        }
+        return;
+    }
+
+    if (it != changes_.end()) {
+        it->second = p;
+    } else {
+        changes_.push_back({c, p});
+    }
+}
+
+Player OverlayBoard::get(Coord c) const {
+    if (const auto* ch = findChange(c)) return ch->second;
+    return base_->get(c);
+}
+
+bool OverlayBoard::set(Coord c, Player p) {
+    if (p == Player::None) {
+        return clear(c);
+    }
+    if (!inBounds(c) || get(c) != Player::None) {
+        return false;
+    }
+    record(c, p);
+    return true;
+}
+
+bool OverlayBoard::clear(Coord c) {
+    if (!inBounds(c) || get(c) == Player::None) {
+        return false;
+    }
+    record(c, Player::None);
+    return true;
+}
+
+std::vector<std::pair<Coord, Player>> OverlayBoard::occupied() const {
+    std::vector<std::pair<Coord, Player>> out = base_->occupied();
+    if (changes_.empty()) return out;
+
+    out.erase(std::remove_if(out.begin(), out.end(), [&](const auto& cp) { return findChange(cp.first) != nullptr; }),
+              out.end());
+    for (const auto& ch : changes_) {
+        if (ch.second != Player::None) out.push_back(ch);
+    }
+    return out;
+}
+
+std::unique_ptr<IBoard> OverlayBoard::clone() const {
+    // Копия не должна зависеть от базы и арены: снимок партии уходит в другой поток.
+    std::unique_ptr<IBoard> out;
+    if (isFinite()) {
+        out = std::make_unique<FiniteBoard>(width(), height());
+    } else {
+        out = std::make_unique<InfiniteBoard>();
+    }
+    for (const auto& [c, p] : occupied()) out->set(c, p);
+    return out;
+}
+
+}
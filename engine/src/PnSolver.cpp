@@ -0,0 +1,439 @@
+#include "../include/engine/PnSolver.h"
+
+#include "../include/engine/Symmetry.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <utility>
+
+namespace engine {
+namespace {
+
+constexpr std::uint32_t INF = 0x3fffffffu;
+
+constexpr int kMaxCells = 64;
+
+std::uint32_t clampInf(std::uint64_t v) {
+    return v >= INF ? INF : static_cast<std::uint32_t>(v);
+}
+
+std::uint64_t mix(std::uint64_t z) {
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+std::size_t roundUpPow2(std::size_t v) {
+    std::size_t p = 4;
+    while (p < v) p <<= 1;
+    return p;
+}
+
+}
+
+PnSolver::PnSolver() : PnSolver(Settings{}) {}
+
+PnSolver::PnSolver(Settings s) : s_(s) {}
+
+bool PnSolver::supports(const RuleSet& rules, const IBoard& board) {
+    if (!board.isFinite()) return false;
+    if (!rules.classicWin) return false;
+    if (rules.weightsEnabled || rules.moveCostsEnabled) return false;
+
+    const long long cells = static_cast<long long>(board.width()) * static_cast<long long>(board.height());
+    return cells > 0 && cells <= kMaxCells;
+}
+
+void PnSolver::clear() {
+    std::fill(table_.begin(), table_.end(), Entry{});
+}
+
+void PnSolver::configure(const RuleSet& rules, const IBoard& board) {
+    const int w = board.width();
+    const int h = board.height();
+    const int n = std::max(1, rules.N);
+
+    if (table_.empty()) {
+        table_.assign(roundUpPow2(std::max<std::size_t>(s_.tableEntries, 4)), Entry{});
+    }
+
+    if (w == width_ && h == height_ && n == N_ && rules.maxMoves == maxMoves_) return;
+
+    width_ = w;
+    height_ = h;
+    N_ = n;
+    maxMoves_ = rules.maxMoves;
+    cells_ = w * h;
+    full_ = (cells_ == 64) ? ~0ull : ((1ull << cells_) - 1);
+
+    windows_.clear();
+    std::vector<int> windowCount(static_cast<std::size_t>(cells_), 0);
+
+    struct Dir { int dx; int dy; };
+    const Dir dirs[4] = {{1,0}, {0,1}, {1,1}, {1,-1}};
+
+    for (int y = 0; y < h; ++y) {
+        for (int x = 0; x < w; ++x) {
+            for (const auto& d : dirs) {
+                const int ex = x + (n - 1) * d.dx;
+                const int ey = y + (n - 1) * d.dy;
+                if (ex < 0 || ex >= w || ey < 0 || ey >= h) continue;
+
+                std::uint64_t mask = 0;
+                for (int k = 0; k < n; ++k) {
+                    const int cell = (y + k * d.dy) * w + (x + k * d.dx);
+                    mask |= 1ull << cell;
+                    ++windowCount[static_cast<std::size_t>(cell)];
+                }
+                windows_.push_back(mask);
+            }
+        }
+    }
+
+    // Клетки, через которые проходит больше окон, перебираем первыми (центр, затем углы).
+    cellOrder_.resize(static_cast<std::size_t>(cells_));
+    for (int i = 0; i < cells_; ++i) cellOrder_[static_cast<std::size_t>(i)] = i;
+    std::stable_sort(cellOrder_.begin(), cellOrder_.end(), [&](int a, int b) {
+        return windowCount[static_cast<std::size_t>(a)] > windowCount[static_cast<std::size_t>(b)];
+    });
+
+    // Без весов и стоимостей правила симметричны при любой симметрии доски.
+    const BoardSymmetry sym = BoardSymmetry::detect(rules, w, h);
+    bytes_ = (cells_ + 7) / 8;
+    symmetries_.clear();
+    for (int t = 1; t < BoardSymmetry::kTransforms; ++t) {
+        if (!sym.has(t)) continue;
+        std::vector<std::uint64_t> perm(static_cast<std::size_t>(bytes_) * 256, 0);
+        for (int b = 0; b < bytes_; ++b) {
+            for (int v = 0; v < 256; ++v) {
+                std::uint64_t out = 0;
+                for (int k = 0; k < 8; ++k) {
+                    const int cell = b * 8 + k;
+                    if (!((v >> k) & 1) || cell >= cells_) continue;
+                    const Coord q = sym.apply(t, Coord{cell % w, cell / w});
+                    out |= 1ull << (q.y * w + q.x);
+                }
+                perm[static_cast<std::size_t>(b) * 256 + static_cast<std::size_t>(v)] = out;
+            }
+        }
+        symmetries_.push_back(std::move(perm));
+    }
+
+    clear();
+}
+
+bool PnSolver::readPosition(const GameState& state, Pos& out) const {
+    out = Pos{};
+    int stones = 0;
+    for (int y = 0; y < height_; ++y) {
+        for (int x = 0; x < width_; ++x) {
+            const int idx = playerIndex(state.board().get(Coord{x, y}));
+            if (idx < 0) continue;
+            out.bits[idx] |= 1ull << (y * width_ + x);
+            ++stones;
+        }
+    }
+    // Ходы считаются по числу камней: позиции с заранее расставленной доской не поддерживаются.
+    return stones == state.moveCount();
+}
+
+std::uint64_t PnSolver::transformed(std::uint64_t bits, const std::vector<std::uint64_t>& perm) const noexcept {
+    std::uint64_t out = 0;
+    for (int b = 0; b < bytes_; ++b) {
+        out |= perm[static_cast<std::size_t>(b) * 256 + ((bits >> (8 * b)) & 0xffu)];
+    }
+    return out;
+}
+
+PnSolver::Pos PnSolver::canonical(const Pos& pos) const noexcept {
+    Pos best = pos;
+    for (const auto& perm : symmetries_) {
+        const Pos t{{transformed(pos.bits[0], perm), transformed(pos.bits[1], perm)}};
+        if (t.bits[0] < best.bits[0] || (t.bits[0] == best.bits[0] && t.bits[1] < best.bits[1])) best = t;
+    }
+    return best;
+}
+
+std::size_t PnSolver::slot(const Pos& pos, int attacker) const noexcept {
+    const std::uint64_t h = mix(pos.bits[0] ^ mix(pos.bits[1] + static_cast<std::uint64_t>(attacker + 1)));
+    return static_cast<std::size_t>(h) & (table_.size() - 1) & ~std::size_t{3};
+}
+
+PnSolver::Bounds PnSolver::lookup(const Pos& position, int attacker) const noexcept {
+    const Pos pos = canonical(position);
+    const std::size_t base = slot(pos, attacker);
+    ++probes_;
+    for (std::size_t i = 0; i < 4; ++i) {
+        const Entry& e = table_[base + i];
+        if (e.used && e.x == pos.bits[0] && e.o == pos.bits[1] && e.attacker == attacker) {
+            ++hits_;
+            return Bounds{e.pn, e.dn, true};
+        }
+    }
+    return Bounds{1, 1, false};
+}
+
+void PnSolver::store(const Pos& position, int attacker, Bounds b, std::uint64_t work) {
+    const Pos pos = canonical(position);
+    const std::size_t base = slot(pos, attacker);
+    Entry* victim = nullptr;
+
+    for (std::size_t i = 0; i < 4; ++i) {
+        Entry& e = table_[base + i];
+        if (e.used && e.x == pos.bits[0] && e.o == pos.bits[1] && e.attacker == attacker) {
+            victim = &e;
+            break;
+        }
+        if (!e.used) {
+            if (!victim || victim->used) victim = &e;
+            continue;
+        }
+        if (!victim || (victim->used && e.work < victim->work)) victim = &e;
+    }
+
+    victim->x = pos.bits[0];
+    victim->o = pos.bits[1];
+    victim->pn = b.pn;
+    victim->dn = b.dn;
+    victim->work = static_cast<std::uint32_t>(std::min<std::uint64_t>(work, std::numeric_limits<std::uint32_t>::max()));
+    victim->attacker = static_cast<std::uint8_t>(attacker);
+    victim->used = true;
+}
+
+bool PnSolver::hasLiveWindow(std::uint64_t blockers) const noexcept {
+    return std::any_of(windows_.begin(), windows_.end(), [&](std::uint64_t w) { return (w & blockers) == 0; });
+}
+
+std::uint64_t PnSolver::winningCells(std::uint64_t own, std::uint64_t opp) const noexcept {
+    std::uint64_t out = 0;
+    for (const std::uint64_t w : windows_) {
+        if ((w & opp) != 0) continue;
+        if (std::popcount(w & own) == N_ - 1) out |= w & ~own;
+    }
+    return out;
+}
+
+PnSolver::Bounds PnSolver::mid(const Pos& pos, int toMove, int attacker, std::uint32_t thpn, std::uint32_t thdn) {
+    const Bounds cached = lookup(pos, attacker);
+    if (cached.pn >= thpn || cached.dn >= thdn) return cached;
+
+    const std::uint64_t startNodes = nodes_;
+    ++nodes_;
+    if ((s_.maxNodes > 0 && nodes_ > s_.maxNodes) || limits_.nodesExhausted(nodes_)
+        || ((nodes_ & 1023) == 0 && limits_.expired())) {
+        aborted_ = true;
+        return cached;
+    }
+
+    const std::uint64_t own = pos.bits[toMove];
+    const std::uint64_t opp = pos.bits[1 - toMove];
+    const std::uint64_t empty = full_ & ~(own | opp);
+    const int stones = std::popcount(own | opp);
+
+    auto finish = [&](bool attackerWins) {
+        const Bounds b = attackerWins ? Bounds{0, INF} : Bounds{INF, 0};
+        store(pos, attacker, b, nodes_ - startNodes);
+        return b;
+    };
+
+    // Ходящий замыкает линию прямо сейчас.
+    if (winningCells(own, opp) & empty) return finish(toMove == attacker);
+
+    // Этот ход последний (доска заполнится или упрёмся в лимит) — ничья, атакующий не доказал победу.
+    if (std::popcount(empty) <= 1 || (maxMoves_ > 0 && stones + 1 >= maxMoves_)) return finish(false);
+
+    if (!hasLiveWindow(pos.bits[1 - attacker])) return finish(false);
+
+    // Две угрозы соперника закрыть нельзя; одна — единственный разумный ход.
+    const std::uint64_t threats = winningCells(opp, own) & empty;
+    if (std::popcount(threats) >= 2) return finish(toMove != attacker);
+    const std::uint64_t moves = threats ? threats : empty;
+
+    const bool orNode = (toMove == attacker);
+
+    Pos kids[kMaxCells];
+    Bounds kb[kMaxCells];
+    int count = 0;
+    for (const int cell : cellOrder_) {
+        const std::uint64_t bit = 1ull << cell;
+        if (!(moves & bit)) continue;
+        Pos child = pos;
+        child.bits[toMove] |= bit;
+        kids[count] = child;
+        kb[count] = lookup(child, attacker);
+        if (!kb[count].known) {
+            // Неизвестный лист: начальная оценка по числу свободных клеток.
+            const std::uint32_t mobility = static_cast<std::uint32_t>(std::popcount(empty & ~bit));
+            kb[count] = orNode ? Bounds{1, mobility} : Bounds{mobility, 1};
+        }
+        ++count;
+    }
+
+    Bounds self{};
+
+    while (true) {
+        std::uint64_t sum = 0;
+        std::uint32_t best = INF;
+        std::uint32_t second = INF;
+        int bestIdx = 0;
+
+        for (int i = 0; i < count; ++i) {
+            const std::uint32_t key = orNode ? kb[i].pn : kb[i].dn;
+            sum += orNode ? kb[i].dn : kb[i].pn;
+            if (key < best) {
+                second = best;
+                best = key;
+                bestIdx = i;
+            } else if (key < second) {
+                second = key;
+            }
+        }
+
+        std::uint32_t total = clampInf(sum);
+        if (best != 0 && total >= INF) total = INF - 1;
+
+        if (orNode) self = Bounds{best, total};
+        else self = Bounds{total, best};
+
+        if (self.pn >= thpn || self.dn >= thdn) break;
+
+        std::uint32_t cpn = 0;
+        std::uint32_t cdn = 0;
+        if (orNode) {
+            cpn = std::min<std::uint32_t>(thpn, clampInf(static_cast<std::uint64_t>(second) + 1));
+            cdn = clampInf(static_cast<std::uint64_t>(thdn) - self.dn + kb[bestIdx].dn);
+        } else {
+            cdn = std::min<std::uint32_t>(thdn, clampInf(static_cast<std::uint64_t>(second) + 1));
+            cpn = clampInf(static_cast<std::uint64_t>(thpn) - self.pn + kb[bestIdx].pn);
+        }
+
+        kb[bestIdx] = mid(kids[bestIdx], 1 - toMove, attacker, cpn, cdn);
+        if (aborted_) return self;
+    }
+
+    store(pos, attacker, self, nodes_ - startNodes);
+    return self;
+}
+
+std::optional<bool> PnSolver::prove(const Pos& pos, int toMove, int attacker) {
+    const Bounds b = mid(pos, toMove, attacker, INF, INF);
+    if (b.pn == 0) return true;
+    if (b.dn == 0) return false;
+    return std::nullopt;
+}
+
+SolveValue PnSolver::valueFor(const Pos& pos, int toMove) {
+    const auto win = prove(pos, toMove, toMove);
+    if (!win) return SolveValue::Unknown;
+    if (*win) return SolveValue::Win;
+
+    const auto loss = prove(pos, toMove, 1 - toMove);
+    if (!loss) return SolveValue::Unknown;
+    return *loss ? SolveValue::Loss : SolveValue::Draw;
+}
+
+SolveValue PnSolver::solve(const GameState& state, const SearchLimits& limits) {
+    if (state.isGameOver()) return SolveValue::Unknown;
+    if (!supports(state.rules(), state.board())) return SolveValue::Unknown;
+
+    configure(state.rules(), state.board());
+
+    Pos root;
+    if (!readPosition(state, root)) return SolveValue::Unknown;
+
+    nodes_ = 0;
+    probes_ = 0;
+    hits_ = 0;
+    aborted_ = false;
+    limits_ = limits;
+    return valueFor(root, playerIndex(state.currentPlayer()));
+}
+
+std::optional<Coord> PnSolver::bestMove(const GameState& state, Player aiPlayer, SolveValue* value,
+                                        const SearchLimits& limits) {
+    if (value) *value = SolveValue::Unknown;
+    if (state.isGameOver()) return std::nullopt;
+    if (aiPlayer != state.currentPlayer()) return std::nullopt;
+    if (!supports(state.rules(), state.board())) return std::nullopt;
+
+    configure(state.rules(), state.board());
+
+    Pos root;
+    if (!readPosition(state, root)) return std::nullopt;
+
+    nodes_ = 0;
+    probes_ = 0;
+    hits_ = 0;
+    aborted_ = false;
+    limits_ = limits;
+
+    const int me = playerIndex(aiPlayer);
+    const std::uint64_t empty = full_ & ~(root.bits[0] | root.bits[1]);
+    if (!empty) return std::nullopt;
+
+    auto toCoord = [&](int cell) { return Coord{cell % width_, cell / width_}; };
+    auto report = [&](SolveValue v, int cell) -> std::optional<Coord> {
+        if (value) *value = v;
+        return toCoord(cell);
+    };
+
+    const std::uint64_t winNow = winningCells(root.bits[me], root.bits[1 - me]) & empty;
+    if (winNow) {
+        for (const int cell : cellOrder_) {
+            if (winNow & (1ull << cell)) return report(SolveValue::Win, cell);
+        }
+    }
+
+    const auto rootWin = prove(root, me, me);
+    if (!rootWin) return std::nullopt;
+
+    const int stones = std::popcount(root.bits[0] | root.bits[1]);
+    const bool lastMove = std::popcount(empty) == 1 || (maxMoves_ > 0 && stones + 1 >= maxMoves_);
+
+    if (*rootWin) {
+        for (const int cell : cellOrder_) {
+            if (!(empty & (1ull << cell))) continue;
+            Pos child = root;
+            child.bits[me] |= 1ull << cell;
+            if (lookup(child, me).pn == 0) return report(SolveValue::Win, cell);
+        }
+        for (const int cell : cellOrder_) {
+            if (!(empty & (1ull << cell))) continue;
+            Pos child = root;
+            child.bits[me] |= 1ull << cell;
+            const auto r = prove(child, 1 - me, me);
+            if (!r) return std::nullopt;
+            if (*r) return report(SolveValue::Win, cell);
+        }
+        return std::nullopt;
+    }
+
+    std::optional<int> firstMove;
+    for (const int cell : cellOrder_) {
+        if (!(empty & (1ull << cell))) continue;
+        if (!firstMove) firstMove = cell;
+        if (lastMove) return report(SolveValue::Draw, cell);
+
+        Pos child = root;
+        child.bits[me] |= 1ull << cell;
+        const auto r = prove(child, 1 - me, 1 - me);
+        if (!r) return std::nullopt;
+        if (!*r) return report(SolveValue::Draw, cell);
+    }
+
+    return report(SolveValue::Loss, *firstMove);
+}
+
+std::string toString(SolveValue v) {
+    switch (v) {
+        case SolveValue::Unknown: return "unknown";
+        case SolveValue::Win: return "win";
+        case SolveValue::Draw: return "draw";
+        case SolveValue::Loss: return "loss";
+        default: return "unknown";
+    }
+}
+
+}
@@ -1,6 +1,43 @@
 #include "../include/engine/RuleSet.h"
 
 namespace engine {
+namespace {
+
+// FNV-1a по значениям полей (не по байтам структуры: там есть выравнивание).
+class Fnv64 {
+public:
+    void add(long long v) {
+        auto u = static_cast<std::uint64_t>(v);
+        for (int i = 0; i < 8; ++i) {
+            h_ ^= (u & 0xffu);
+            h_ *= 0x100000001b3ull;
+            u >>= 8;
+        }
+    }
+
+    void add(const CellValueFunction& f) {
+        add(static_cast<long long>(f.type));
+        add(f.constant);
+        add(f.scale);
+        add(f.offset);
+        add(f.originX);
+        add(f.originY);
+        add(f.tableWidth);
+        add(f.tableHeight);
+        add(f.tableOffsetX);
+        add(f.tableOffsetY);
+        add(f.defaultValue);
+        add(static_cast<long long>(f.table.size()));
+        for (int v : f.table) add(v);
+    }
+
+    std::uint64_t value() const noexcept { return h_; }
+
+private:
+    std::uint64_t h_ = 0xcbf29ce484222325ull;
+};
+
+}
 
 std::vector<std::string> RuleSet::validateAndFix() {
     std::vector<std::string> warnings;
@@ -57,6 +94,32 @@ std::vector<std::string> RuleSet::validateAndFix() {
     return warnings;
 }
 
+std::uint64_t RuleSet::fingerprint() const {
+    Fnv64 h;
+    h.add(static_cast<long long>(topology));
+    h.add(width);
+    h.add(height);
+    h.add(N);
+    h.add(static_cast<long long>(lineMode));
+    h.add(countSubsegments);
+    h.add(classicWin);
+    h.add(maximizeLines);
+    h.add(maxMoves);
+    // Выключенные подсистемы не влияют на игру: их параметры не должны менять ключ.
+    h.add(weightsEnabled);
+    if (weightsEnabled) {
+        h.add(weightFunction);
+        h.add(targetScore);
+    }
+    h.add(moveCostsEnabled);
+    if (moveCostsEnabled) {
+        h.add(costFunction);
+        h.add(static_cast<long long>(costMode));
+        h.add(initialBudget);
+    }
+    return h.value();
+}
+
 std::string toString(BoardTopology t) {
     switch (t) {
         case BoardTopology::Finite: return "finite";
@@ -0,0 +1,271 @@
+#include "../include/engine/ScoreBounds.h"
+
+#include "../include/engine/Scoring.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+
+namespace engine {
+namespace {
+
+constexpr int kDirs[4][2] = { {1, 0}, {0, 1}, {1, 1}, {1, -1} };
+
+enum : std::uint8_t { Free = 0, Own = 1, Closed = 2 };
+
+// Сумма k наибольших из неотрицательных значений (порядок в v может портиться). Малые k — вставками.
+template <class T>
+T topSum(std::vector<T>& v, int k) {
+    if (k <= 0 || v.empty()) return T{};
+    constexpr int kSmall = 8;
+    if (k <= kSmall) {
+        T top[kSmall]{};
+        int n = 0;
+        for (const T x : v) {
+            if (x <= T{} || (n == k && x <= top[n - 1])) continue;
+            int j = n < k ? n++ : n - 1;
+            for (; j > 0 && top[j - 1] < x; --j) top[j] = top[j - 1];
+            top[j] = x;
+        }
+        T s{};
+        for (int j = 0; j < n; ++j) s += top[j];
+        return s;
+    }
+    const auto n = std::min(v.size(), static_cast<std::size_t>(k));
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(n) - 1, v.end(), std::greater<T>());
+    T s{};
+    for (std::size_t i = 0; i < n; ++i) s += v[i];
+    return s;
+}
+
+}
+
+ScoreBounds::ScoreBounds(const RuleSet& rules, int width, int height) : rules_(rules) {
+    if (rules.topology != BoardTopology::Finite || width <= 0 || height <= 0) return;
+
+    width_ = width;
+    height_ = height;
+    rules_.width = width;
+    rules_.height = height;
+    scoreBound_ = Scoring::scoreBound(rules_);
+
+    const std::size_t cells = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+    weight_.assign(cells, 0);
+    cost_.assign(cells, 0);
+    for (int y = 0; y < height; ++y) {
+        for (int x = 0; x < width; ++x) {
+            const std::size_t i = static_cast<std::size_t>(y) * static_cast<std::size_t>(width) + static_cast<std::size_t>(x);
+            if (rules.weightsEnabled) weight_[i] = rules.weightFunction.value(Coord{x, y});
+            if (rules.moveCostsEnabled) cost_[i] = std::max(0, rules.costFunction.value(Coord{x, y}));
+            if (weight_[i] < 0) nonNegative_ = false;
+        }
+    }
+}
+
+ScoreBounds::Reach ScoreBounds::reach(const IBoard& board, Player p, int lines, long long score, int moves,
+                                      long long budget) const {
+    Reach r;
+    if (!enabled()) {
+        r.minLines = 0;
+        r.maxLines = std::numeric_limits<int>::max() / 4;
+        r.minScore = std::numeric_limits<long long>::min() / 4;
+        r.maxScore = std::numeric_limits<long long>::max() / 4;
+        r.canWin = rules_.classicWin || (rules_.weightsEnabled && rules_.targetScore > 0);
+        return r;
+    }
+
+    const int N = std::max(1, rules_.N);
+    const auto cells = static_cast<std::size_t>(width_) * static_cast<std::size_t>(height_);
+    const bool budgeted = rules_.moveCostsEnabled && rules_.costMode == CostMode::CostFromBudget && budget >= 0;
+    const bool exactN = rules_.lineMode == LineLengthMode::ExactN;
+    const bool subsegments = !exactN && rules_.countSubsegments;
+    const bool weights = rules_.weightsEnabled && nonNegative_;
+
+    // Клетка: свободна и по карману / своя / закрыта (чужой камень или слишком дорогая клетка).
+    state_.resize(cells);
+    free_.clear();
+    costs_.clear();
+    for (std::size_t i = 0; i < cells; ++i) {
+        const Player q = board.get(Coord{static_cast<int>(i) % width_, static_cast<int>(i) / width_});
+        if (q == p) {
+            state_[i] = Own;
+        } else if (q == Player::None && (!budgeted || cost_[i] <= budget)) {
+            state_[i] = Free;
+            free_.push_back(static_cast<int>(i));
+            costs_.push_back(cost_[i]);
+        } else {
+            state_[i] = Closed;
+        }
+    }
+
+    int k = std::max(0, moves);
+    if (budgeted) {
+        // Самые дешёвые ходы первыми: больше ходов бюджет не оплатит.
+        std::sort(costs_.begin(), costs_.end());
+        long long spent = 0;
+        int affordable = 0;
+        for (const int c : costs_) {
+            if (spent + c > budget) break;
+            spent += c;
+            ++affordable;
+        }
+        k = std::min(k, affordable);
+    }
+
+    r.minLines = r.maxLines = lines;
+    r.minScore = r.maxScore = score;
+    if (k == 0) return r;
+
+    // Отрезок AtLeastN без подотрезков оценивается целиком, остальным хватает N клеток в каждую сторону.
+    const bool wholeSegment = weights && !exactN && !subsegments;
+    const int reachCells = wholeSegment ? std::max(width_, height_) : N;
+    rel_.resize(static_cast<std::size_t>(2 * reachCells + 1));
+    relW_.resize(static_cast<std::size_t>(2 * reachCells + 2));
+
+    // Для каждой свободной клетки: сколько линий / очков может добавить и отнять один ход в неё.
+    gainLines_.assign(free_.size(), 0);
+    lossLines_.assign(free_.size(), 0);
+    gainScore_.assign(free_.size(), 0);
+    lossScore_.assign(free_.size(), 0);
+
+    for (std::size_t f = 0; f < free_.size(); ++f) {
+        const int cx = free_[f] % width_;
+        const int cy = free_[f] / width_;
+
+        for (const auto& d : kDirs) {
+            auto open = [&](int t) {
+                const int x = cx + d[0] * t;
+                const int y = cy + d[1] * t;
+                return x >= 0 && x < width_ && y >= 0 && y < height_
+                    && state_[static_cast<std::size_t>(y * width_ + x)] != Closed;
+            };
+            int back = 0;
+            while (back < reachCells && open(-(back + 1))) ++back;
+            int fwd = 0;
+            while (fwd < reachCells && open(fwd + 1)) ++fwd;
+            if (back + fwd + 1 < N) continue; // линия через клетку в этом направлении невозможна
+
+            // Клетки отрезка со смещением -back..fwd: свободна ли и префикс весов.
+            relW_[0] = 0;
+            for (int t = -back; t <= fwd; ++t) {
+                const auto cell = static_cast<std::size_t>((cy + d[1] * t) * width_ + cx + d[0] * t);
+                const auto o = static_cast<std::size_t>(t + back);
+                rel_[o] = state_[cell];
+                relW_[o + 1] = relW_[o] + weight_[cell];
+            }
+            auto weightIn = [&](int a, int b) { // смещения [a, b)
+                return relW_[static_cast<std::size_t>(b + back)] - relW_[static_cast<std::size_t>(a + back)];
+            };
+
+            // Окна из N клеток через клетку, с 1..k свободными: только из них может возникнуть линия.
+            const int lo = -std::min(back, N - 1);
+            const int hi = std::min(fwd, N - 1);
+            int windows = 0;
+            long long windowsScore = 0;
+            long long bestWindow = 0;
+            int empties = 0;
+            for (int t = lo; t < lo + N - 1; ++t) empties += rel_[static_cast<std::size_t>(t + back)] == Free ? 1 : 0;
+            for (int s = lo; s + N - 1 <= hi; ++s) {
+                empties += rel_[static_cast<std::size_t>(s + N - 1 + back)] == Free ? 1 : 0;
+                if (s > lo) empties -= rel_[static_cast<std::size_t>(s - 1 + back)] == Free ? 1 : 0;
+                if (empties > k) continue;
+                ++windows;
+                if (weights) {
+                    const long long w = weightIn(s, s + N) * N;
+                    windowsScore += w;
+                    bestWindow = std::max(bestWindow, w);
+                }
+            }
+
+            if (windows > 0) {
+                if (rules_.classicWin) r.canWin = true;
+                // Без подотрезков ход даёт не больше линии на направление, с ними — по линии на окно.
+                gainLines_[f] += subsegments ? windows : 1;
+                if (weights) {
+                    gainScore_[f] += subsegments ? windowsScore
+                                   : exactN ? bestWindow
+                                            : weightIn(-back, fwd + 1) * (back + fwd + 1);
+                }
+            }
+
+            // Потеря при склейке: соседний отрезок ровно из N (ExactN) или два длинных (без подотрезков).
+            if (subsegments) continue;
+            const bool left = back >= N;
+            const bool right = fwd >= N;
+            if (exactN) {
+                lossLines_[f] += (left ? 1 : 0) + (right ? 1 : 0);
+                if (weights && left) lossScore_[f] += weightIn(-N, 0) * N;
+                if (weights && right) lossScore_[f] += weightIn(1, N + 1) * N;
+            } else if (left && right) {
+                lossLines_[f] += 1;
+            }
+        }
+    }
+
+    // k лучших клеток ограничивают всё, что игрок ещё успеет сделать.
+    r.maxLines = lines + topSum(gainLines_, k);
+    r.minLines = lines - std::min(lines, topSum(lossLines_, k));
+
+    if (rules_.weightsEnabled) {
+        if (weights) {
+            r.maxScore = score + topSum(gainScore_, k);
+            r.minScore = score - topSum(lossScore_, k);
+        } else {
+            // Отрицательные веса: только общий предел |score|.
+            r.maxScore = std::max(score, scoreBound_);
+            r.minScore = std::min(score, -scoreBound_);
+        }
+    }
+
+    if (rules_.moveCostsEnabled && rules_.costMode == CostMode::CostFromScore) r.minScore -= topSum(costs_, k);
+
+    if (rules_.weightsEnabled && rules_.targetScore > 0 && r.maxScore >= rules_.targetScore) r.canWin = true;
+    return r;
+}
+
+ScoreBounds::Reach ScoreBounds::reach(const GameState& state, Player p) const {
+    const RuleSet& rules = state.rules();
+    const long long budget = rules.moveCostsEnabled && rules.costMode == CostMode::CostFromBudget ? state.stats(p).budget : -1;
+    return reach(state.board(), p, state.stats(p).lines, state.stats(p).score, movesLeft(state, p), budget);
+}
+
+int ScoreBounds::movesLeft(const GameState& state, Player p) {
+    if (state.isGameOver()) return 0;
+
+    const IBoard& board = state.board();
+    const RuleSet& rules = state.rules();
+    int left = std::numeric_limits<int>::max();
+    if (board.isFinite()) left = board.width() * board.height() - state.moveCount();
+    if (rules.maxMoves > 0) left = std::min(left, rules.maxMoves - state.moveCount());
+    left = std::max(0, left);
+
+    // При бюджетах игрок без денег пропускает ход, и все оставшиеся ходы может сделать другой.
+    if (rules.moveCostsEnabled && rules.costMode == CostMode::CostFromBudget) return left;
+    return p == state.currentPlayer() ? left - left / 2 : left / 2;
+}
+
+std::optional<GameResult> ScoreBounds::lockedResult(const GameState& state) const {
+    if (state.isGameOver()) return state.result();
+    if (!enabled()) return std::nullopt;
+
+    const Reach x = reach(state, Player::X);
+    const Reach o = reach(state, Player::O);
+    if (x.canWin || o.canWin) return std::nullopt;
+
+    auto byScore = [&]() -> std::optional<GameResult> {
+        if (!rules_.weightsEnabled && !rules_.moveCostsEnabled) return GameResult::Draw;
+        if (x.minScore > o.maxScore) return GameResult::WinX;
+        if (o.minScore > x.maxScore) return GameResult::WinO;
+        if (x.minScore == x.maxScore && o.minScore == o.maxScore && x.minScore == o.minScore) return GameResult::Draw;
+        return std::nullopt;
+    };
+
+    if (!rules_.maximizeLines) return byScore();
+
+    if (x.minLines > o.maxLines) return GameResult::WinX;
+    if (o.minLines > x.maxLines) return GameResult::WinO;
+    if (x.minLines == x.maxLines && o.minLines == o.maxLines && x.minLines == o.minLines) return byScore();
+    return std::nullopt;
+}
+
+}
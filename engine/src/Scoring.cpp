@@ -1,8 +1,7 @@
 #include "../include/engine/Scoring.h"
 
 #include <algorithm>
-#include <numeric>
-#include <vector>
+#include <cstdlib>
 
 namespace engine {
 namespace {
@@ -12,15 +11,18 @@ struct Contribution {
     long long score = 0;
 };
 
-Contribution evaluateRun(const std::vector<int>& w, const RuleSet& rules) {
+// Вклад максимального отрезка из R клеток, начиная со start по (dx, dy). Веса считаются на лету, без буферов:
+// при подсчёте подотрезков клетка j входит в min(j+1, R-j, N, R-N+1) окон длины N.
+Contribution evaluateRun(Coord start, int dx, int dy, int R, const RuleSet& rules) {
     Contribution c;
-    const int R = static_cast<int>(w.size());
     const int N = std::max(1, rules.N);
 
     if (R <= 0) return c;
 
     auto sumWeights = [&]() -> long long {
-        return std::accumulate(w.begin(), w.end(), 0LL);
+        long long s = 0;
+        for (int i = 0; i < R; ++i) s += rules.weightFunction.value(Coord{start.x + dx * i, start.y + dy * i});
+        return s;
     };
 
     switch (rules.lineMode) {
@@ -39,16 +41,12 @@ Contribution evaluateRun(const std::vector<int>& w, const RuleSet& rules) {
                 if (rules.countSubsegments) {
                     c.lines = R - N + 1;
                     if (rules.weightsEnabled) {
-                        std::vector<long long> prefix(static_cast<std::size_t>(R) + 1, 0);
-                        for (int i = 0; i < R; ++i) {
-                            prefix[static_cast<std::size_t>(i) + 1] = prefix[static_cast<std::size_t>(i)] + w[static_cast<std::size_t>(i)];
-                        }
                         long long s = 0;
-                        for (int i = 0; i <= R - N; ++i) {
-                            long long segSum = prefix[static_cast<std::size_t>(i) + N] - prefix[static_cast<std::size_t>(i)];
-                            s += segSum * N;
+                        for (int j = 0; j < R; ++j) {
+                            const int windows = std::min({j + 1, R - j, N, R - N + 1});
+                            s += static_cast<long long>(rules.weightFunction.value(Coord{start.x + dx * j, start.y + dy * j})) * windows;
                         }
-                        c.score = s;
+                        c.score = s * N;
                     }
                 } else {
                     c.lines = 1;
@@ -64,20 +62,16 @@ Contribution evaluateRun(const std::vector<int>& w, const RuleSet& rules) {
     return c;
 }
 
-void gatherSide(const IBoard& board,
-                Coord start,
-                int dx,
-                int dy,
-                Player p,
-                const CellValueFunction& func,
-                std::vector<int>& outWeights) {
-    outWeights.clear();
+// Длина отрезка камней p, начиная со start по (dx, dy).
+int runLength(const IBoard& board, Coord start, int dx, int dy, Player p) {
+    int len = 0;
     Coord c = start;
     while (board.inBounds(c) && board.get(c) == p) {
-        outWeights.push_back(func.value(c));
+        ++len;
         c.x += dx;
         c.y += dy;
     }
+    return len;
 }
 
 }
@@ -92,41 +86,76 @@ MoveDelta Scoring::computeMoveDelta(const IBoard& board, Coord c, Player p, cons
         return total;
     }
 
-    const auto& wFunc = rules.weightFunction;
-    const int wCenter = wFunc.value(c);
-
     struct Dir { int dx; int dy; };
     const Dir dirs[4] = { {1,0}, {0,1}, {1,1}, {1,-1} };
 
-    std::vector<int> leftW;
-    std::vector<int> rightW;
-    std::vector<int> mergedW;
+    for (const auto& d : dirs) {
+        const Coord leftStart{c.x - d.dx, c.y - d.dy};
+        const Coord rightStart{c.x + d.dx, c.y + d.dy};
+        const int left = runLength(board, leftStart, -d.dx, -d.dy, p);
+        const int right = runLength(board, rightStart, d.dx, d.dy, p);
+        const int merged = left + 1 + right;
+
+        const Contribution oldLeft = evaluateRun(leftStart, -d.dx, -d.dy, left, rules);
+        const Contribution oldRight = evaluateRun(rightStart, d.dx, d.dy, right, rules);
+        const Contribution newMerged = evaluateRun(Coord{c.x - d.dx * left, c.y - d.dy * left}, d.dx, d.dy, merged, rules);
+
+        total.linesDelta += newMerged.lines - oldLeft.lines - oldRight.lines;
+        total.scoreDelta += newMerged.score - oldLeft.score - oldRight.score;
+        total.maxRunLen = std::max(total.maxRunLen, merged);
+    }
+
+    return total;
+}
+
+LineTotals Scoring::computeTotals(const IBoard& board, Player p, const RuleSet& rules) {
+    LineTotals total;
+    if (!board.isFinite()) return total;
+
+    struct Dir { int dx; int dy; };
+    const Dir dirs[4] = { {1,0}, {0,1}, {1,1}, {1,-1} };
 
     for (const auto& d : dirs) {
-        gatherSide(board, Coord{c.x - d.dx, c.y - d.dy}, -d.dx, -d.dy, p, wFunc, leftW);
-        gatherSide(board, Coord{c.x + d.dx, c.y + d.dy}, d.dx, d.dy, p, wFunc, rightW);
+        for (int y = 0; y < board.height(); ++y) {
+            for (int x = 0; x < board.width(); ++x) {
+                const Coord c{x, y};
+                if (board.get(c) != p) continue;
 
-        mergedW.clear();
-        mergedW.reserve(leftW.size() + 1 + rightW.size());
+                // Считаем только от начала максимального отрезка.
+                const Coord prev{x - d.dx, y - d.dy};
+                if (board.inBounds(prev) && board.get(prev) == p) continue;
 
-        for (auto it = leftW.rbegin(); it != leftW.rend(); ++it) {
-            mergedW.push_back(*it);
-        }
-        mergedW.push_back(wCenter);
-        for (int w : rightW) {
-            mergedW.push_back(w);
+                const int len = runLength(board, c, d.dx, d.dy, p);
+
+                const Contribution contrib = evaluateRun(c, d.dx, d.dy, len, rules);
+                total.lines += contrib.lines;
+                total.score += contrib.score;
+                total.maxRunLen = std::max(total.maxRunLen, len);
+            }
         }
+    }
 
-        Contribution oldLeft = evaluateRun(leftW, rules);
-        Contribution oldRight = evaluateRun(rightW, rules);
-        Contribution newMerged = evaluateRun(mergedW, rules);
+    return total;
+}
 
-        total.linesDelta += newMerged.lines - oldLeft.lines - oldRight.lines;
-        total.scoreDelta += newMerged.score - oldLeft.score - oldRight.score;
-        total.maxRunLen = std::max(total.maxRunLen, static_cast<int>(mergedW.size()));
+long long Scoring::scoreBound(const RuleSet& rules) {
+    // Каждая клетка входит не более чем в один максимальный отрезок на направление; отрезок даёт sum(w) * len,
+    // а при подсчёте подотрезков клетка попадает максимум в N окон по w * N.
+    long long sumW = 0;
+    long long sumCost = 0;
+    for (int y = 0; y < rules.height; ++y) {
+        for (int x = 0; x < rules.width; ++x) {
+            const Coord c{x, y};
+            if (rules.weightsEnabled) sumW += std::llabs(static_cast<long long>(rules.weightFunction.value(c)));
+            if (rules.moveCostsEnabled && rules.costMode == CostMode::CostFromScore) {
+                sumCost += std::max(0, rules.costFunction.value(c));
+            }
+        }
     }
 
-    return total;
+    const long long lineLen = std::max(rules.width, rules.height);
+    const long long perCell = std::max<long long>(lineLen, static_cast<long long>(rules.N) * rules.N);
+    return 4 * sumW * perCell + sumCost;
 }
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,44 @@
+#include "../include/engine/SearchArena.h"
+
+namespace engine {
+
+void* SearchArena::Upstream::do_allocate(std::size_t n, std::size_t align) {
+    bytes += n;
+    return std::pmr::new_delete_resource()->allocate(n, align);
+}
+
+void SearchArena::Upstream::do_deallocate(void* p, std::size_t n, std::size_t align) {
+    std::pmr::new_delete_resource()->deallocate(p, n, align);
+}
+
+SearchArena::SearchArena(std::size_t initialBytes) {
+    allocate(initialBytes);
+}
+
+SearchArena::SearchArena(const SearchArena& other) {
+    allocate(other.size_);
+}
+
+SearchArena& SearchArena::operator=(const SearchArena& other) {
+    if (this != &other) allocate(other.size_);
+    return *this;
+}
+
+void SearchArena::allocate(std::size_t bytes) {
+    arena_.reset(); // возвращает взятое сверху до замены буфера
+    size_ = bytes > 0 ? bytes : 1;
+    buffer_ = std::make_unique<std::byte[]>(size_);
+    upstream_.bytes = 0;
+    arena_.emplace(buffer_.get(), size_, &upstream_);
+}
+
+void SearchArena::reset() {
+    if (upstream_.bytes == 0) {
+        arena_->release();
+        return;
+    }
+    // Прошлый поиск не уместился: следующий получает буфер с запасом.
+    allocate((size_ + upstream_.bytes) * 2);
+}
+
+}
@@ -0,0 +1,62 @@
+#include "../include/engine/SearchStats.h"
+
+#include <sstream>
+
+namespace engine {
+namespace {
+
+long long micros(SearchStats::Duration d) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+}
+
+std::string toString(MoveSource s) {
+    switch (s) {
+        case MoveSource::None: return "none";
+        case MoveSource::Tablebase: return "tablebase";
+        case MoveSource::OpeningBook: return "opening_book";
+        case MoveSource::Classic3x3: return "classic3x3";
+        case MoveSource::ClassicSolver: return "classic_solver";
+        case MoveSource::EndgameSolver: return "endgame_solver";
+        case MoveSource::Heuristic: return "heuristic";
+        default: return "unknown";
+    }
+}
+
+std::string toString(const SearchStats& s) {
+    std::ostringstream out;
+    out << "source=" << toString(s.source);
+    if (s.move) out << " move=" << s.move->x << "," << s.move->y;
+    out << " limit_hit=" << (s.limitHit ? 1 : 0)
+        << " result_locked=" << (s.resultLocked ? 1 : 0)
+        << " nodes=" << s.nodes
+        << " candidates=" << s.candidatesGenerated
+        << " legal=" << s.legalMoves
+        << " symmetric_skipped=" << s.symmetricSkipped
+        << " top=" << s.topMoves
+        << " second_ply_moves=" << s.secondPlyMoves
+        << " evals_classic=" << s.classicEvals
+        << " evals_score=" << s.scoreEvals
+        << " replies=" << s.secondPlyReplies
+        << " solver_nodes=" << s.solverNodes
+        << " cache_probes=" << s.cacheProbes
+        << " cache_hit_rate=" << s.cacheHitRate()
+        << " t_solver_us=" << micros(s.solverTime)
+        << " t_candidates_us=" << micros(s.candidateTime)
+        << " t_first_ply_us=" << micros(s.firstPlyTime)
+        << " t_sort_us=" << micros(s.sortTime)
+        << " t_second_ply_us=" << micros(s.secondPlyTime)
+        << " t_total_us=" << micros(s.totalTime)
+        << " score_first_ply=" << s.breakdown.firstPly
+        << " score_opp_best=" << s.breakdown.opponentBest
+        << " score_defense_mul=" << s.breakdown.defenseMul
+        << " score_noise=" << s.breakdown.noise
+        << " score_total=" << s.breakdown.total
+        << " lines_delta=" << s.breakdown.delta.linesDelta
+        << " score_delta=" << s.breakdown.delta.scoreDelta
+        << " cost=" << s.breakdown.cost;
+    return out.str();
+}
+
+}
@@ -0,0 +1,99 @@
+#include "../include/engine/Symmetry.h"
+
+namespace engine {
+namespace {
+
+std::uint64_t mix(std::uint64_t z) {
+    z += 0x9e3779b97f4a7c15ull;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    return z ^ (z >> 31);
+}
+
+bool invariant(const CellValueFunction& f, const BoardSymmetry& sym, int t) {
+    for (int y = 0; y < sym.height(); ++y) {
+        for (int x = 0; x < sym.width(); ++x) {
+            const Coord c{x, y};
+            if (f.value(c) != f.value(sym.apply(t, c))) return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+BoardSymmetry BoardSymmetry::detect(const RuleSet& rules, int width, int height) {
+    BoardSymmetry sym;
+    if (rules.topology != BoardTopology::Finite || width <= 0 || height <= 0) return sym;
+
+    sym.width_ = width;
+    sym.height_ = height;
+
+    for (int t = 1; t < kTransforms; ++t) {
+        // Повороты на 90 и диагональные отражения есть только у квадратной доски.
+        const bool needsSquare = t == 1 || t == 3 || t == 6 || t == 7;
+        if (needsSquare && width != height) continue;
+
+        if (rules.weightsEnabled && !invariant(rules.weightFunction, sym, t)) continue;
+        if (rules.moveCostsEnabled && !invariant(rules.costFunction, sym, t)) continue;
+        sym.mask_ |= static_cast<std::uint8_t>(1u << t);
+    }
+    return sym;
+}
+
+Coord BoardSymmetry::apply(int t, Coord c) const noexcept {
+    const int mx = width_ - 1;
+    const int my = height_ - 1;
+    switch (t) {
+        case 1: return Coord{my - c.y, c.x};
+        case 2: return Coord{mx - c.x, my - c.y};
+        case 3: return Coord{c.y, mx - c.x};
+        case 4: return Coord{mx - c.x, c.y};
+        case 5: return Coord{c.x, my - c.y};
+        case 6: return Coord{c.y, c.x};
+        case 7: return Coord{my - c.y, mx - c.x};
+        default: return c;
+    }
+}
+
+std::uint8_t BoardSymmetry::stabilizer(const IBoard& board) const {
+    std::uint8_t out = 1;
+    if (trivial() || !board.isFinite()) return out;
+
+    const auto stones = board.occupied();
+    for (int t = 1; t < kTransforms; ++t) {
+        if (!has(t)) continue;
+        bool same = true;
+        for (const auto& [c, p] : stones) {
+            if (board.get(apply(t, c)) != p) {
+                same = false;
+                break;
+            }
+        }
+        if (same) out |= static_cast<std::uint8_t>(1u << t);
+    }
+    return out;
+}
+
+std::uint64_t BoardSymmetry::canonicalHash(const IBoard& board, int* transform) const {
+    std::uint64_t h[kTransforms]{};
+    for (const auto& [c, p] : board.occupied()) {
+        for (int t = 0; t < kTransforms; ++t) {
+            if (!has(t)) continue;
+            const Coord q = apply(t, c);
+            // Обе координаты целиком: на бесконечной доске width_ == 0 и отрицательные x.
+            const std::uint64_t cell = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(q.x)) << 32)
+                                     | static_cast<std::uint32_t>(q.y);
+            h[t] ^= mix(cell * 3 + (p == Player::X ? 1 : 2));
+        }
+    }
+
+    int best = 0;
+    for (int t = 1; t < kTransforms; ++t) {
+        if (has(t) && h[t] < h[best]) best = t;
+    }
+    if (transform) *transform = best;
+    return h[best];
+}
+
+}
@@ -0,0 +1,307 @@
+#include "../include/engine/Tablebase.h"
+
+#include "../include/engine/FiniteBoard.h"
+#include "../include/engine/Scoring.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <thread>
+#include <vector>
+
+namespace engine {
+namespace {
+
+constexpr char kMagic[8] = {'A', 'T', 'T', 'T', 'T', 'B', '0', '1'};
+constexpr std::uint32_t kVersion = 1;
+
+std::vector<std::uint64_t> powersOf3(int cells) {
+    std::vector<std::uint64_t> pow3(static_cast<std::size_t>(cells) + 1, 1);
+    for (int i = 1; i <= cells; ++i) pow3[static_cast<std::size_t>(i)] = pow3[static_cast<std::size_t>(i) - 1] * 3;
+    return pow3;
+}
+
+// Следующее число с тем же количеством единичных битов (Gosper's hack).
+std::uint32_t nextCombination(std::uint32_t v) {
+    const std::uint32_t t = v | (v - 1);
+    return (t + 1) | (((~t & -~t) - 1) >> (std::countr_zero(v) + 1));
+}
+
+class Sweep {
+public:
+    Sweep(const RuleSet& rules, long long linesScale, std::vector<std::int32_t>& values)
+        : rules_(rules),
+          width_(rules.width),
+          cells_(rules.width * rules.height),
+          pow3_(powersOf3(cells_)),
+          linesScale_(linesScale),
+          values_(values) {}
+
+    // Все позиции с k камнями; part/parts делят перебор между потоками.
+    void layer(int k, unsigned part, unsigned parts) {
+        FiniteBoard board(rules_.width, rules_.height);
+
+        const std::uint32_t limit = std::uint32_t{1} << cells_;
+        std::uint32_t occ = (k == 0) ? 0u : ((std::uint32_t{1} << k) - 1);
+        std::uint64_t counter = 0;
+
+        while (occ < limit) {
+            if (counter++ % parts == part) {
+                solveOccupancy(occ, k, board);
+            }
+            if (occ == 0) break;
+            occ = nextCombination(occ);
+        }
+    }
+
+private:
+    const RuleSet& rules_;
+    int width_;
+    int cells_;
+    std::vector<std::uint64_t> pow3_;
+    long long linesScale_;
+    std::vector<std::int32_t>& values_;
+
+    Coord coordOf(int cell) const { return Coord{cell % width_, cell / width_}; }
+
+    void solveOccupancy(std::uint32_t occ, int k, FiniteBoard& board) {
+        int cellsOf[32]{};
+        int n = 0;
+        for (std::uint32_t m = occ; m; m &= m - 1) cellsOf[n++] = std::countr_zero(m);
+
+        const int xs = (k + 1) / 2;
+        const std::uint32_t subLimit = std::uint32_t{1} << k;
+        std::uint32_t sub = (xs == 0) ? 0u : ((std::uint32_t{1} << xs) - 1);
+
+        while (sub < subLimit) {
+            std::uint32_t xm = 0;
+            for (int i = 0; i < k; ++i) {
+                if (sub & (std::uint32_t{1} << i)) xm |= std::uint32_t{1} << cellsOf[i];
+            }
+            solvePosition(xm, occ & ~xm, k, board);
+
+            if (sub == 0) break;
+            sub = nextCombination(sub);
+        }
+    }
+
+    void solvePosition(std::uint32_t xm, std::uint32_t om, int k, FiniteBoard& board) {
+        std::uint64_t idx = 0;
+        for (std::uint32_t m = xm; m; m &= m - 1) idx += pow3_[static_cast<std::size_t>(std::countr_zero(m))];
+        for (std::uint32_t m = om; m; m &= m - 1) idx += 2 * pow3_[static_cast<std::size_t>(std::countr_zero(m))];
+
+        const int xs = std::popcount(xm);
+        const int os = std::popcount(om);
+        const Player mover = (xs == os) ? Player::X : Player::O;
+        const Player last = other(mover);
+        const int empties = cells_ - k;
+
+        for (std::uint32_t m = xm; m; m &= m - 1) (void)board.set(coordOf(std::countr_zero(m)), Player::X);
+        for (std::uint32_t m = om; m; m &= m - 1) (void)board.set(coordOf(std::countr_zero(m)), Player::O);
+
+        const LineTotals tm = Scoring::computeTotals(board, mover, rules_);
+        const LineTotals tl = Scoring::computeTotals(board, last, rules_);
+
+        for (std::uint32_t m = xm | om; m; m &= m - 1) (void)board.clear(coordOf(std::countr_zero(m)));
+
+        std::int32_t value = 0;
+
+        const bool classicEnd = rules_.classicWin && tl.maxRunLen >= rules_.N;
+        const bool targetEnd = rules_.weightsEnabled && rules_.targetScore > 0 && tl.score >= rules_.targetScore;
+
+        if (classicEnd || targetEnd) {
+            value = -(Tablebase::kWinValue + empties);
+        } else if (empties == 0 || (rules_.maxMoves > 0 && k >= rules_.maxMoves)) {
+            long long margin = tm.score - tl.score;
+            if (rules_.maximizeLines) margin += static_cast<long long>(tm.lines - tl.lines) * linesScale_;
+            value = static_cast<std::int32_t>(margin);
+        } else {
+            const std::uint64_t digit = (mover == Player::X) ? 1 : 2;
+            std::int32_t best = std::numeric_limits<std::int32_t>::min();
+            const std::uint32_t free = ~(xm | om) & ((std::uint32_t{1} << cells_) - 1);
+            for (std::uint32_t m = free; m; m &= m - 1) {
+                const int cell = std::countr_zero(m);
+                const std::int32_t child = values_[static_cast<std::size_t>(idx + digit * pow3_[static_cast<std::size_t>(cell)])];
+                best = std::max(best, static_cast<std::int32_t>(-child));
+            }
+            value = best;
+        }
+
+        values_[static_cast<std::size_t>(idx)] = value;
+    }
+};
+
+}
+
+bool Tablebase::supports(const RuleSet& rules) {
+    if (rules.topology != BoardTopology::Finite) return false;
+    if (rules.moveCostsEnabled) return false;
+    if (rules.width <= 0 || rules.height <= 0) return false;
+    return rules.width * rules.height <= kMaxCells;
+}
+
+bool Tablebase::generate(const RuleSet& rulesIn, const std::string& path, unsigned threads, std::string* error) {
+    auto fail = [&](const std::string& msg) {
+        if (error) *error = msg;
+        return false;
+    };
+
+    RuleSet rules = rulesIn;
+    rules.validateAndFix();
+    if (!supports(rules)) return fail("rules are not supported (finite board, at most 16 cells, no move costs)");
+
+    const int cells = rules.width * rules.height;
+
+    const long long scoreBound = Scoring::scoreBound(rules);
+    const long long linesScale = 2 * scoreBound + 1;
+    const long long maxLines = 4LL * cells;
+
+    if (maxLines * linesScale + scoreBound >= kWinValue) {
+        return fail("weights are too large to pack line and score margins into 32-bit values");
+    }
+
+    const auto pow3 = powersOf3(cells);
+    std::vector<std::int32_t> values(static_cast<std::size_t>(pow3[static_cast<std::size_t>(cells)]), kNoValue);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    Sweep sweep(rules, linesScale, values);
+
+    // Слой k зависит только от слоя k+1, внутри слоя позиции независимы.
+    for (int k = cells; k >= 0; --k) {
+        std::vector<std::thread> pool;
+        pool.reserve(threads);
+        for (unsigned t = 0; t < threads; ++t) {
+            pool.emplace_back([&sweep, k, t, threads]() { sweep.layer(k, t, threads); });
+        }
+        for (auto& th : pool) th.join();
+    }
+
+    Header header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.width = static_cast<std::uint32_t>(rules.width);
+    header.height = static_cast<std::uint32_t>(rules.height);
+    header.rulesFingerprint = rules.fingerprint();
+    header.entryCount = values.size();
+    header.linesScale = linesScale;
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) return fail("cannot open " + path + " for writing");
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(values.data()),
+              static_cast<std::streamsize>(values.size() * sizeof(std::int32_t)));
+    if (!out) return fail("failed to write " + path);
+
+    return true;
+}
+
+bool Tablebase::open(const std::string& path) {
+    close();
+    if (!file_.open(path)) return false;
+
+    if (file_.size() < sizeof(Header)) {
+        close();
+        return false;
+    }
+    std::memcpy(&header_, file_.data(), sizeof(Header));
+
+    const bool valid = std::memcmp(header_.magic, kMagic, sizeof(kMagic)) == 0
+                    && header_.version == kVersion
+                    && header_.width > 0 && header_.height > 0
+                    && header_.width * header_.height <= static_cast<std::uint32_t>(kMaxCells)
+                    && header_.entryCount == powersOf3(static_cast<int>(header_.width * header_.height)).back()
+                    && file_.size() == sizeof(Header) + header_.entryCount * sizeof(std::int32_t);
+    if (!valid) {
+        close();
+        return false;
+    }
+
+    entries_ = reinterpret_cast<const std::int32_t*>(file_.data() + sizeof(Header));
+    return true;
+}
+
+void Tablebase::close() noexcept {
+    file_.close();
+    header_ = Header{};
+    entries_ = nullptr;
+}
+
+bool Tablebase::matches(const RuleSet& rules) const noexcept {
+    if (!isOpen()) return false;
+    if (rules.topology != BoardTopology::Finite) return false;
+    if (static_cast<std::uint32_t>(rules.width) != header_.width) return false;
+    if (static_cast<std::uint32_t>(rules.height) != header_.height) return false;
+    return rules.fingerprint() == header_.rulesFingerprint;
+}
+
+std::optional<std::uint64_t> Tablebase::indexOf(const GameState& state) const {
+    if (!matches(state.rules())) return std::nullopt;
+
+    const IBoard& board = state.board();
+    if (!board.isFinite()) return std::nullopt;
+
+    std::uint64_t idx = 0;
+    std::uint64_t mul = 1;
+    int stones = 0;
+    for (int y = 0; y < board.height(); ++y) {
+        for (int x = 0; x < board.width(); ++x) {
+            const Player p = board.get(Coord{x, y});
+            if (p != Player::None) ++stones;
+            idx += mul * static_cast<std::uint64_t>(p);
+            mul *= 3;
+        }
+    }
+    if (stones != state.moveCount()) return std::nullopt;
+    return idx;
+}
+
+std::optional<std::int32_t> Tablebase::probe(const GameState& state) const {
+    const auto idx = indexOf(state);
+    if (!idx) return std::nullopt;
+    const std::int32_t v = entries_[*idx];
+    if (v == kNoValue) return std::nullopt;
+    return v;
+}
+
+std::optional<Coord> Tablebase::bestMove(const GameState& state, Player aiPlayer, std::int32_t* value) const {
+    if (state.isGameOver() || state.currentPlayer() != aiPlayer) return std::nullopt;
+
+    const auto idx = indexOf(state);
+    if (!idx) return std::nullopt;
+
+    const IBoard& board = state.board();
+    const std::uint64_t digit = static_cast<std::uint64_t>(aiPlayer);
+    const Coord center{board.width() / 2, board.height() / 2};
+
+    std::optional<Coord> best;
+    std::int32_t bestValue = kNoValue;
+    long long bestDist = 0;
+
+    std::uint64_t mul = 1;
+    for (int y = 0; y < board.height(); ++y) {
+        for (int x = 0; x < board.width(); ++x, mul *= 3) {
+            const Coord c{x, y};
+            if (!board.isEmpty(c)) continue;
+
+            const std::int32_t child = entries_[*idx + digit * mul];
+            if (child == kNoValue) continue;
+
+            const std::int32_t v = -child;
+            const long long dist = std::llabs(static_cast<long long>(x) - center.x) + std::llabs(static_cast<long long>(y) - center.y);
+            if (!best || v > bestValue || (v == bestValue && dist < bestDist)) {
+                best = c;
+                bestValue = v;
+                bestDist = dist;
+            }
+        }
+    }
+
+    if (best && value) *value = bestValue;
+    return best;
+}
+
+}
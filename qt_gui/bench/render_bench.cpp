@@ -0,0 +1,202 @@
+#include <QApplication>
+#include <QCommandLineOption>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QGraphicsScene>
+#include <QPixmap>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AppConfig.h"
+#include "BoardView.h"
+#include "MainWindow.h"
+
+namespace {
+
+struct Scenario {
+    std::string name;
+    engine::BoardTopology topology = engine::BoardTopology::Finite;
+    int size = 0; // finite: side of the board
+    int stones = 0;
+};
+
+struct FrameStats {
+    std::size_t frames = 0;
+    double min = 0, median = 0, p95 = 0, max = 0, mean = 0;
+};
+
+FrameStats summarize(std::vector<double> ms) {
+    FrameStats s;
+    if (ms.empty()) return s;
+    std::sort(ms.begin(), ms.end());
+    s.frames = ms.size();
+    s.min = ms.front();
+    s.max = ms.back();
+    s.median = ms[ms.size() / 2];
+    s.p95 = ms[std::min(ms.size() - 1, static_cast<std::size_t>(std::ceil(ms.size() * 0.95)) - 1)];
+    double sum = 0;
+    for (double v : ms) sum += v;
+    s.mean = sum / ms.size();
+    return s;
+}
+
+// Резидентная память процесса из /proc (только Linux; иначе -1).
+long long rssKb() {
+    QFile f("/proc/self/status");
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text)) return -1;
+    while (!f.atEnd()) {
+        const QByteArray line = f.readLine();
+        if (line.startsWith("VmRSS:")) return line.mid(6).trimmed().split(' ').front().toLongLong();
+    }
+    return -1;
+}
+
+// i-й камень партии: построчно по квадрату со стороной ceil(sqrt(stones)), на бесконечной доске — вокруг (0,0).
+engine::Coord cellFor(const Scenario& sc, int i) {
+    if (sc.topology == engine::BoardTopology::Finite) return engine::Coord{i % sc.size, i / sc.size};
+    const int side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(sc.stones))));
+    return engine::Coord{i % side - side / 2, i / side - side / 2};
+}
+
+double grabMs(BoardView* view) {
+    QElapsedTimer t;
+    t.start();
+    const QPixmap frame = view->viewport()->grab(); // полная отрисовка сцены в видимой области
+    (void)frame;
+    return t.nsecsElapsed() / 1e6;
+}
+
+void printJson(const Scenario& sc, int placed, double placeMs, int items, long long rss, const FrameStats& fit,
+               const FrameStats& zoom, const FrameStats& pan) {
+    auto frames = [](const char* name, const FrameStats& s) {
+        std::cout << "\"" << name << "\":{\"frames\":" << s.frames << ",\"min_ms\":" << s.min
+                  << ",\"median_ms\":" << s.median << ",\"p95_ms\":" << s.p95 << ",\"max_ms\":" << s.max
+                  << ",\"mean_ms\":" << s.mean << "}";
+    };
+    std::cout << "{\"scenario\":\"" << sc.name << "\",\"topology\":\""
+              << (sc.topology == engine::BoardTopology::Finite ? "finite" : "infinite") << "\",\"size\":" << sc.size
+              << ",\"stones\":" << placed << ",\"place_ms\":" << placeMs
+              << ",\"place_us_per_move\":" << (placed > 0 ? placeMs * 1000.0 / placed : 0.0)
+              << ",\"scene_items\":" << items << ",\"rss_kb\":" << rss << ",";
+    frames("fit", fit);
+    std::cout << ",";
+    frames("zoom", zoom);
+    std::cout << ",";
+    frames("pan", pan);
+    std::cout << "}" << std::endl;
+}
+
+}
+
+// Headless render benchmark: render_bench [--max-stones N] [--steps S] [--cell-size PX] [--only NAME]
+//
+// Every scenario builds MainWindow's scene for an empty board, places the stones through BoardView clicks (the
+// same path as a human), then renders the view: fitted to the board, zooming in step by step, panning across and
+// zooming back out. One JSON object per scenario is printed per line, so runs on different commits can be diffed.
+// Runs without a display: the offscreen platform is used unless QT_QPA_PLATFORM says otherwise.
+int main(int argc, char** argv) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication app(argc, argv);
+    QCoreApplication::setApplicationName("render_bench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Headless rendering benchmark for the board view (JSON lines on stdout).");
+    parser.addHelpOption();
+    parser.addOption(QCommandLineOption("max-stones", "Cap on stones per scenario (default 100000).", "int", "100000"));
+    parser.addOption(QCommandLineOption("steps", "Frames per zoom / pan sweep (default 24).", "int", "24"));
+    parser.addOption(QCommandLineOption("cell-size", "Cell size in pixels (default 40).", "int", "40"));
+    parser.addOption(QCommandLineOption("only", "Run only the scenario with this name.", "name"));
+    parser.process(app);
+
+    const int maxStones = std::max(1, parser.value("max-stones").toInt());
+    const int steps = std::max(1, parser.value("steps").toInt());
+    const int cellSize = std::max(2, parser.value("cell-size").toInt());
+    const QString only = parser.value("only");
+
+    // Конечные доски заполняются наполовину (полная доска закончила бы партию), бесконечные — до 10^5 камней.
+    std::vector<Scenario> scenarios;
+    for (const int side : {10, 50, 100, 250, 500}) {
+        scenarios.push_back({"finite-" + std::to_string(side), engine::BoardTopology::Finite, side, side * side / 2});
+    }
+    for (const int stones : {1000, 10000, 100000}) {
+        scenarios.push_back({"infinite-" + std::to_string(stones), engine::BoardTopology::Infinite, 0, stones});
+    }
+
+    for (Scenario sc : scenarios) {
+        if (!only.isEmpty() && only != QString::fromStdString(sc.name)) continue;
+        sc.stones = std::min(sc.stones, maxStones);
+
+        // Без классической победы партия не кончается до заполнения доски, и диалог конца игры не появляется.
+        AppConfig cfg;
+        cfg.rules.topology = sc.topology;
+        cfg.rules.width = std::max(1, sc.size);
+        cfg.rules.height = std::max(1, sc.size);
+        cfg.rules.N = 5;
+        cfg.rules.classicWin = false;
+        cfg.rules.maximizeLines = true;
+        cfg.aiEnabled = false;
+        cfg.aiPonder = false;
+        cfg.cellSizePx = cellSize;
+
+        MainWindow w(cfg);
+        w.resize(1200, 800);
+        w.show();
+        app.processEvents();
+
+        auto* view = w.findChild<BoardView*>();
+        if (!view || !view->scene()) {
+            std::cerr << "render_bench: board view not found\n";
+            return 1;
+        }
+
+        QElapsedTimer placeTimer;
+        placeTimer.start();
+        for (int i = 0; i < sc.stones; ++i) {
+            const engine::Coord c = cellFor(sc, i);
+            emit view->cellClicked(c.x, c.y);
+            if (i % 1000 == 999) app.processEvents();
+        }
+        app.processEvents();
+        const double placeMs = placeTimer.nsecsElapsed() / 1e6;
+
+        const QRectF board = view->scene()->sceneRect();
+        std::vector<double> fit, zoom, pan;
+
+        view->resetViewToRect(board);
+        app.processEvents();
+        for (int i = 0; i < 3; ++i) fit.push_back(grabMs(view));
+
+        // Приближение до ~крупных клеток: проходит все уровни детализации слоя камней и сетки.
+        constexpr qreal kStep = 1.15;
+        for (int i = 0; i < steps; ++i) {
+            view->scale(kStep, kStep);
+            app.processEvents();
+            zoom.push_back(grabMs(view));
+        }
+
+        // Панорама по диагонали доски на достигнутом масштабе.
+        for (int i = 0; i <= steps; ++i) {
+            const qreal t = static_cast<qreal>(i) / steps;
+            view->centerOn(board.left() + board.width() * t, board.top() + board.height() * t);
+            app.processEvents();
+            pan.push_back(grabMs(view));
+        }
+
+        for (int i = 0; i < steps; ++i) {
+            view->scale(1.0 / kStep, 1.0 / kStep);
+            app.processEvents();
+            zoom.push_back(grabMs(view));
+        }
+
+        printJson(sc, sc.stones, placeMs, static_cast<int>(view->scene()->items().size()), rssKb(), summarize(fit),
+                  summarize(zoom), summarize(pan));
+    }
+
+    return 0;
+}
@@ -0,0 +1,297 @@
+#include "AiWorker.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace {
+
+// Не чаще ~30 раз в секунду: чаще GUI всё равно не перерисует.
+constexpr qint64 kProgressIntervalMs = 33;
+
+// Сколько вероятных ответов человека обдумывается заранее.
+constexpr int kPonderReplies = 4;
+
+}
+
+AiWorker::AiWorker(QObject* parent)
+    : QObject(parent) {}
+
+void AiWorker::configure(const engine::SimpleAI::Settings& s,
+                         std::shared_ptr<const engine::Tablebase> tablebase,
+                         std::shared_ptr<const engine::OpeningBook> book) {
+    ai_ = engine::SimpleAI(s);
+    ai_.setTablebase(std::move(tablebase));
+    ai_.setOpeningBook(std::move(book));
+}
+
+void AiWorker::think(const Request& r) {
+    AiResult res;
+    res.id = r.id;
+    res.player = r.player;
+    res.pondered = r.reply.has_value();
+
+    // При обдумывании сначала делаем на снимке предполагаемый ход человека.
+    std::optional<engine::GameState> played;
+    const engine::GameState* state = r.state.get();
+    if (r.reply) {
+        played.emplace(*r.state);
+        if (!played->tryMakeMove(*r.reply).ok) r.stop->store(true);
+        state = &*played;
+    }
+    res.moveCount = state->moveCount();
+
+    // Отменённый до начала запрос не ищем вовсе.
+    if (!r.stop->load() && !state->isGameOver() && state->currentPlayer() == r.player) {
+        ai_.setProgressCallback([&](const engine::SearchProgress& p) {
+            if (sinceProgress_.isValid() && sinceProgress_.elapsed() < kProgressIntervalMs) return;
+            sinceProgress_.start();
+            emit progressed(AiProgress{r.id, r.player, p});
+        });
+        sinceProgress_.invalidate();
+
+        engine::SearchLimits limits;
+        limits.stop = r.stop.get();
+        res.move = ai_.chooseMove(*state, r.player, limits, r.seeds);
+        res.stats = ai_.lastStats();
+        ai_.setProgressCallback(nullptr);
+    }
+
+    emit finished(res);
+}
+
+void AiWorker::predict(const Request& r, int count) {
+    AiPrediction p;
+    p.id = r.id;
+    if (!r.stop->load()) p.replies = ai_.rankMoves(*r.state, r.player, static_cast<std::size_t>(std::max(0, count)));
+    emit predicted(p);
+}
+
+void AiWorker::autoplay(const Request& r, const std::shared_ptr<AutoplayFeed>& feed) {
+    using Clock = std::chrono::steady_clock;
+
+    engine::GameState game(*r.state);
+    Clock::time_point next = Clock::now();
+
+    while (!feed->stop.load() && !game.isGameOver()) {
+        engine::SearchLimits limits;
+        limits.stop = &feed->stop;
+        const std::optional<engine::Coord> move = ai_.chooseMove(game, game.currentPlayer(), limits);
+        if (feed->stop.load() || !move || !game.tryMakeMove(*move).ok) break;
+
+        {
+            std::lock_guard<std::mutex> lock(feed->mutex);
+            feed->moves.push_back(*move);
+        }
+
+        // Темп: ждём до следующего хода короткими отрезками, чтобы стоп и смена скорости действовали сразу.
+        for (;;) {
+            const int rate = feed->movesPerSecond.load();
+            if (rate <= 0 || feed->stop.load()) {
+                next = Clock::now();
+                break;
+            }
+            const Clock::time_point due = next + std::chrono::microseconds(1'000'000 / rate);
+            const Clock::time_point now = Clock::now();
+            if (now >= due) {
+                next = std::max(due, now - std::chrono::milliseconds(100)); // после долгого поиска не догоняем
+                break;
+            }
+            std::this_thread::sleep_for(std::min<Clock::duration>(due - now, std::chrono::milliseconds(10)));
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(feed->mutex);
+    feed->finished = true;
+}
+
+AiRunner::AiRunner(QObject* parent)
+    : QObject(parent) {
+    qRegisterMetaType<AiProgress>();
+    qRegisterMetaType<AiResult>();
+    qRegisterMetaType<AiPrediction>();
+
+    thread_ = new QThread(this);
+    thread_->setObjectName("ai");
+
+    worker_ = new AiWorker;
+    worker_->moveToThread(thread_);
+    connect(thread_, &QThread::finished, worker_, &QObject::deleteLater);
+
+    // Разные потоки: сигналы приходят очередью в поток GUI.
+    connect(worker_, &AiWorker::progressed, this, &AiRunner::onWorkerProgressed);
+    connect(worker_, &AiWorker::finished, this, &AiRunner::onWorkerFinished);
+    connect(worker_, &AiWorker::predicted, this, &AiRunner::onWorkerPredicted);
+
+    thread_->start();
+}
+
+AiRunner::~AiRunner() {
+    cancel();
+    thread_->quit();
+    thread_->wait();
+}
+
+void AiRunner::configure(const engine::SimpleAI::Settings& s,
+                         std::shared_ptr<const engine::Tablebase> tablebase,
+                         std::shared_ptr<const engine::OpeningBook> book) {
+    AiWorker* w = worker_;
+    QMetaObject::invokeMethod(worker_, [w, s, tablebase = std::move(tablebase), book = std::move(book)]() {
+        w->configure(s, tablebase, book);
+    }, Qt::QueuedConnection);
+}
+
+void AiRunner::start(const engine::GameState& game, engine::Player player) {
+    if (stop_) stop_->store(true);
+    stop_.reset();
+    current_ = 0;
+
+    // Человек сыграл предсказанный ход: готовый ответ отдаём сразу, недосчитанный поиск становится основным.
+    if (PonderLine* line = ponderHit(game, player)) {
+        const quint64 id = line->id;
+        const std::shared_ptr<std::atomic<bool>> stop = std::move(line->stop);
+        const std::optional<AiResult> result = line->result;
+        stopPondering();
+
+        current_ = id;
+        if (result) {
+            QMetaObject::invokeMethod(this, [this, r = *result]() { onWorkerFinished(r); }, Qt::QueuedConnection);
+        } else {
+            stop_ = stop;
+        }
+        return;
+    }
+
+    AiWorker::Request r;
+    r.id = nextId_++;
+    r.state = std::make_shared<const engine::GameState>(game); // снимок: дальше партия живёт своей жизнью
+    r.player = player;
+    r.stop = std::make_shared<std::atomic<bool>>(false);
+
+    // Ответы на другие ходы человека обычно хороши и здесь: с них поиск и начинается.
+    for (const PonderLine& line : ponder_) {
+        if (line.result && line.result->move) r.seeds.push_back(*line.result->move);
+    }
+    stopPondering();
+
+    current_ = r.id;
+    stop_ = r.stop;
+    post(r);
+}
+
+void AiRunner::cancel() {
+    if (stop_) stop_->store(true);
+    stop_.reset();
+    current_ = 0;
+    stopPondering();
+    if (autoplay_) autoplay_->stop.store(true);
+    autoplay_.reset();
+}
+
+void AiRunner::finishNow() {
+    if (stop_) stop_->store(true);
+}
+
+void AiRunner::ponder(const engine::GameState& game, engine::Player aiPlayer) {
+    stopPondering();
+    if (game.isGameOver() || aiPlayer == engine::Player::None || game.currentPlayer() == aiPlayer) return;
+
+    ponderBase_ = std::make_shared<const engine::GameState>(game);
+    ponderPlayer_ = aiPlayer;
+
+    AiWorker::Request r;
+    r.id = nextId_++;
+    r.state = ponderBase_;
+    r.player = game.currentPlayer();
+    r.stop = std::make_shared<std::atomic<bool>>(false);
+    predictId_ = r.id;
+    predictStop_ = r.stop;
+
+    AiWorker* w = worker_;
+    QMetaObject::invokeMethod(worker_, [w, r]() { w->predict(r, kPonderReplies); }, Qt::QueuedConnection);
+}
+
+void AiRunner::stopPondering() {
+    if (predictStop_) predictStop_->store(true);
+    for (const PonderLine& line : ponder_) {
+        if (line.stop) line.stop->store(true);
+    }
+    ponder_.clear();
+    ponderBase_.reset();
+    ponderPlayer_ = engine::Player::None;
+    predictId_ = 0;
+    predictStop_.reset();
+}
+
+void AiRunner::autoplay(const engine::GameState& game, const std::shared_ptr<AutoplayFeed>& feed) {
+    cancel();
+    autoplay_ = feed;
+
+    AiWorker::Request r;
+    r.id = nextId_++;
+    r.state = std::make_shared<const engine::GameState>(game);
+
+    AiWorker* w = worker_;
+    QMetaObject::invokeMethod(worker_, [w, r, feed]() { w->autoplay(r, feed); }, Qt::QueuedConnection);
+}
+
+void AiRunner::post(const AiWorker::Request& r) {
+    AiWorker* w = worker_;
+    QMetaObject::invokeMethod(worker_, [w, r]() { w->think(r); }, Qt::QueuedConnection);
+}
+
+AiRunner::PonderLine* AiRunner::ponderHit(const engine::GameState& game, engine::Player player) {
+    if (!ponderBase_ || player != ponderPlayer_ || !game.lastMove()) return nullptr;
+    if (game.moveCount() != ponderBase_->moveCount() + 1) return nullptr;
+    for (PonderLine& line : ponder_) {
+        if (line.reply == *game.lastMove()) return &line;
+    }
+    return nullptr;
+}
+
+void AiRunner::onWorkerProgressed(const AiProgress& p) {
+    if (p.id == current_) emit progressed(p);
+}
+
+void AiRunner::onWorkerFinished(const AiResult& r) {
+    if (r.id == current_) {
+        current_ = 0;
+        stop_.reset();
+        emit moveReady(r);
+        return;
+    }
+
+    // Ответ на предполагаемый ход человека: ждёт, сыграет ли человек этот ход.
+    for (PonderLine& line : ponder_) {
+        if (line.id == r.id) {
+            line.result = r;
+            line.stop.reset();
+            return;
+        }
+    }
+}
+
+void AiRunner::onWorkerPredicted(const AiPrediction& p) {
+    if (p.id != predictId_ || !ponderBase_) return;
+    predictStop_.reset();
+
+    // Все ответы ставятся в очередь потока сразу; считаются по одному, самый вероятный первым.
+    for (const engine::Coord& reply : p.replies) {
+        PonderLine line;
+        line.reply = reply;
+        line.id = nextId_++;
+        line.stop = std::make_shared<std::atomic<bool>>(false);
+
+        AiWorker::Request r;
+        r.id = line.id;
+        r.state = ponderBase_;
+        r.reply = reply;
+        r.player = ponderPlayer_;
+        r.stop = line.stop;
+        post(r);
+
+        ponder_.push_back(std::move(line));
+    }
+}
@@ -0,0 +1,162 @@
+#ifndef TIKTAKTOE_AIWORKER_H
+#define TIKTAKTOE_AIWORKER_H
+#pragma once
+
+#include <QElapsedTimer>
+#include <QMetaType>
+#include <QObject>
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <engine/AI.h>
+#include <engine/GameState.h>
+
+class QThread;
+
+struct AiProgress {
+    quint64 id = 0;
+    engine::Player player = engine::Player::None;
+    engine::SearchProgress search;
+};
+
+struct AiResult {
+    quint64 id = 0;
+    engine::Player player = engine::Player::None;
+    int moveCount = 0; // of the snapshot the move was searched for
+    std::optional<engine::Coord> move;
+    engine::SearchStats stats;
+    bool pondered = false; // found on the human's time
+};
+
+// Likely human replies of a ponder request, best first.
+struct AiPrediction {
+    quint64 id = 0;
+    std::vector<engine::Coord> replies;
+};
+
+// Moves of an autoplay game: the AI thread appends them as it plays, the GUI drains them once per frame.
+struct AutoplayFeed {
+    std::atomic<int> movesPerSecond{0}; // 0 = as fast as the AI searches; may change while playing
+    std::atomic<bool> stop{false};
+
+    std::mutex mutex;
+    std::vector<engine::Coord> moves; // guarded by mutex
+    bool finished = false;            // guarded by mutex: game over, no move or stopped
+
+    // Moves played since the last call, and whether the game on the AI thread has ended.
+    std::vector<engine::Coord> take(bool& done) {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::vector<engine::Coord> out;
+        out.swap(moves);
+        done = finished;
+        return out;
+    }
+};
+
+Q_DECLARE_METATYPE(AiProgress)
+Q_DECLARE_METATYPE(AiResult)
+Q_DECLARE_METATYPE(AiPrediction)
+
+// Lives on the AI thread and owns the SimpleAI. Requests arrive as queued calls, so they run one after another.
+class AiWorker : public QObject {
+    Q_OBJECT
+public:
+    struct Request {
+        quint64 id = 0;
+        std::shared_ptr<const engine::GameState> state;
+        std::optional<engine::Coord> reply; // pondering: the human move to play on the snapshot first
+        engine::Player player = engine::Player::None;
+        std::shared_ptr<std::atomic<bool>> stop;
+        std::vector<engine::Coord> seeds; // searched first
+    };
+
+    explicit AiWorker(QObject* parent = nullptr);
+
+    void configure(const engine::SimpleAI::Settings& s,
+                   std::shared_ptr<const engine::Tablebase> tablebase,
+                   std::shared_ptr<const engine::OpeningBook> book);
+    void think(const Request& r);
+    void predict(const Request& r, int count); // r.player = the human
+    void autoplay(const Request& r, const std::shared_ptr<AutoplayFeed>& feed); // both sides, until over or stopped
+
+signals:
+    void progressed(const AiProgress& p);
+    void finished(const AiResult& r);
+    void predicted(const AiPrediction& p);
+
+private:
+    engine::SimpleAI ai_;
+    QElapsedTimer sinceProgress_;
+};
+
+// GUI-side handle of the AI thread. start() searches a snapshot of the game, so the GUI keeps the real GameState
+// and may undo or start a new game at any time; cancel() drops the running request and its result never arrives.
+//
+// ponder() uses the human's time: it predicts the likely replies and searches the AI's answer to each in turn.
+// If the human plays one of them, start() delivers the finished answer at once or adopts the search still running;
+// otherwise the answers found so far seed the new search.
+class AiRunner : public QObject {
+    Q_OBJECT
+public:
+    explicit AiRunner(QObject* parent = nullptr);
+    ~AiRunner() override;
+
+    // Applies to the requests started after it.
+    void configure(const engine::SimpleAI::Settings& s,
+                   std::shared_ptr<const engine::Tablebase> tablebase,
+                   std::shared_ptr<const engine::OpeningBook> book);
+
+    void start(const engine::GameState& game, engine::Player player);
+    void cancel();     // result is discarded, pondering stops too
+    void finishNow();  // search stops, the best move found so far is delivered
+
+    void ponder(const engine::GameState& game, engine::Player aiPlayer); // the human is to move
+    void stopPondering();
+
+    // AI vs AI without the GUI in the loop: moves arrive through the feed, cancel() stops it too.
+    void autoplay(const engine::GameState& game, const std::shared_ptr<AutoplayFeed>& feed);
+
+    bool isBusy() const noexcept { return current_ != 0; }
+    bool isPondering() const noexcept { return ponderBase_ != nullptr; }
+
+signals:
+    void progressed(const AiProgress& p);
+    void moveReady(const AiResult& r);
+
+private slots:
+    void onWorkerProgressed(const AiProgress& p);
+    void onWorkerFinished(const AiResult& r);
+    void onWorkerPredicted(const AiPrediction& p);
+
+private:
+    struct PonderLine {
+        engine::Coord reply{};
+        quint64 id = 0;
+        std::shared_ptr<std::atomic<bool>> stop;
+        std::optional<AiResult> result;
+    };
+
+    void post(const AiWorker::Request& r);
+    PonderLine* ponderHit(const engine::GameState& game, engine::Player player);
+
+    QThread* thread_ = nullptr;
+    AiWorker* worker_ = nullptr;
+
+    quint64 nextId_ = 1;
+    quint64 current_ = 0; // 0 = idle
+    std::shared_ptr<std::atomic<bool>> stop_;
+
+    std::shared_ptr<const engine::GameState> ponderBase_; // position the human is thinking about
+    engine::Player ponderPlayer_ = engine::Player::None;
+    quint64 predictId_ = 0;
+    std::shared_ptr<std::atomic<bool>> predictStop_;
+    std::vector<PonderLine> ponder_;
+
+    std::shared_ptr<AutoplayFeed> autoplay_;
+};
+
+#endif
@@ -158,6 +158,7 @@ AppConfig AppConfig::fromParser(const QCommandLineParser& parser) {
     cfg.aiEnabled = false;
     cfg.aiPlayer = engine::Player::O;
     cfg.aiCandidateRadius = 2;
+    cfg.aiPonder = true;
 
     cfg.cellSizePx = 40;
 
@@ -219,6 +220,9 @@ AppConfig AppConfig::fromParser(const QCommandLineParser& parser) {
                 if (!ok) cfg.warnings << "ai.player invalid; using O.";
             }
             cfg.aiCandidateRadius = s.value("candidateRadius", cfg.aiCandidateRadius).toInt();
+            cfg.aiPonder = s.value("ponder", cfg.aiPonder).toBool();
+            cfg.tablebaseFile = s.value("tablebase", cfg.tablebaseFile).toString();
+            cfg.openingBookFile = s.value("openingBook", cfg.openingBookFile).toString();
             s.endGroup();
 
             s.beginGroup("ui");
@@ -279,6 +283,9 @@ AppConfig AppConfig::fromParser(const QCommandLineParser& parser) {
     }
 
     if (parser.isSet("ai-radius")) cfg.aiCandidateRadius = parser.value("ai-radius").toInt();
+    applyBoolPair(parser, "ponder", "no-ponder", cfg.aiPonder);
+    if (parser.isSet("tablebase")) cfg.tablebaseFile = parser.value("tablebase");
+    if (parser.isSet("opening-book")) cfg.openingBookFile = parser.value("opening-book");
     if (parser.isSet("cell-size")) cfg.cellSizePx = parser.value("cell-size").toInt();
 
     const auto w = cfg.rules.validateAndFix();
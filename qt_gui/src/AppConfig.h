@@ -15,6 +15,9 @@ struct AppConfig {
     bool aiEnabled = false;
     engine::Player aiPlayer = engine::Player::O;
     int aiCandidateRadius = 2;
+    bool aiPonder = true; // think on the human's time (human vs AI only)
+    QString tablebaseFile;
+    QString openingBookFile;
 
     int cellSizePx = 40;
     QString configFile;
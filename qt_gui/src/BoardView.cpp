@@ -35,6 +35,21 @@ void BoardView::resetViewToRect(const QRectF& rect) {
     if (rect.isValid() && !rect.isEmpty()) {
         fitInView(rect, Qt::KeepAspectRatio);
     }
+    emit viewportChanged();
+}
+
+QRectF BoardView::visibleSceneRect() const {
+    return mapToScene(viewport()->rect()).boundingRect();
+}
+
+void BoardView::scrollContentsBy(int dx, int dy) {
+    QGraphicsView::scrollContentsBy(dx, dy);
+    emit viewportChanged();
+}
+
+void BoardView::resizeEvent(QResizeEvent* event) {
+    QGraphicsView::resizeEvent(event);
+    emit viewportChanged();
 }
 
 void BoardView::wheelEvent(QWheelEvent* event) {
@@ -44,6 +59,7 @@ void BoardView::wheelEvent(QWheelEvent* event) {
     } else {
         scale(1.0 / factor, 1.0 / factor);
     }
+    emit viewportChanged();
     event->accept();
 }
 
@@ -16,10 +16,15 @@ public:
 
     void resetViewToRect(const QRectF& rect);
 
+    QRectF visibleSceneRect() const;
+
     signals:
         void cellClicked(int x, int y);
+        void viewportChanged(); // scrolled, zoomed or resized
 
 protected:
+    void scrollContentsBy(int dx, int dy) override;
+    void resizeEvent(QResizeEvent* event) override;
     void wheelEvent(QWheelEvent* event) override;
     void mousePressEvent(QMouseEvent* event) override;
     void mouseMoveEvent(QMouseEvent* event) override;
@@ -0,0 +1,156 @@
+#include "EvalOverlayItem.h"
+
+#include <QColor>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+EvalOverlayItem::EvalOverlayItem(const QRectF& rect, int cellSizePx)
+    : rect_(rect), cellSize_(std::max(2, cellSizePx)) {
+    setZValue(1); // между сеткой и камнями
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void EvalOverlayItem::setRect(const QRectF& r) {
+    prepareGeometryChange();
+    rect_ = r;
+}
+
+void EvalOverlayItem::setMetric(Metric m) {
+    if (metric_ == m) return;
+    metric_ = m;
+    rangeStale_ = true;
+    update();
+}
+
+void EvalOverlayItem::setPlayer(engine::Player p) {
+    if (player_ == p || p == engine::Player::None) return;
+    player_ = p;
+    rangeStale_ = true;
+    update();
+}
+
+void EvalOverlayItem::setScores(const std::vector<EvalCell>& cells) {
+    const long long lo = lo_;
+    const long long hi = hi_;
+    QRectF dirty;
+    for (const EvalCell& cell : cells) {
+        Tile& tile = tiles_[Tiles::tileOf(cell.c)];
+        auto [it, inserted] = tile.try_emplace(cell.c, cell);
+        if (inserted) {
+            ++cellCount_;
+        } else {
+            dropFromRange(it->second);
+            it->second = cell;
+        }
+        widenRange(cell);
+        dirty |= cellRect(cell.c);
+    }
+
+    // Шкала общая для всех клеток: если её края сдвинулись, перекрашивается всё, иначе только пришедшие клетки.
+    if (rangeStale_ || lo_ != lo || hi_ != hi) update();
+    else if (!dirty.isEmpty()) update(dirty);
+}
+
+void EvalOverlayItem::removeCell(engine::Coord c) {
+    auto t = tiles_.find(Tiles::tileOf(c));
+    if (t == tiles_.end()) return;
+    auto it = t->second.find(c);
+    if (it == t->second.end()) return;
+
+    dropFromRange(it->second);
+    t->second.erase(it);
+    if (t->second.empty()) tiles_.erase(t);
+    --cellCount_;
+
+    if (rangeStale_) update();
+    else update(cellRect(c));
+}
+
+void EvalOverlayItem::clear() {
+    tiles_.clear();
+    cellCount_ = 0;
+    lo_ = 0;
+    hi_ = -1;
+    rangeStale_ = false;
+    update();
+}
+
+long long EvalOverlayItem::valueOf(const EvalCell& cell) const {
+    const engine::SimpleAI::CellScore& s = cell.of(player_);
+    if (metric_ == Metric::Own) return s.own;
+    if (metric_ == Metric::Opponent) return s.opponent;
+    return s.move;
+}
+
+QRectF EvalOverlayItem::cellRect(engine::Coord c) const {
+    return QRectF(c.x * cellSize_, c.y * cellSize_, cellSize_, cellSize_);
+}
+
+void EvalOverlayItem::widenRange(const EvalCell& cell) {
+    if (rangeStale_ || !cell.of(player_).legal) return; // устаревшая шкала всё равно будет пересчитана
+    const long long v = valueOf(cell);
+    if (lo_ > hi_) {
+        lo_ = hi_ = v;
+        return;
+    }
+    lo_ = std::min(lo_, v);
+    hi_ = std::max(hi_, v);
+}
+
+void EvalOverlayItem::dropFromRange(const EvalCell& cell) {
+    if (rangeStale_ || !cell.of(player_).legal) return;
+    const long long v = valueOf(cell);
+    if (v == lo_ || v == hi_) rangeStale_ = true; // край мог сдвинуться внутрь: пересчёт при отрисовке
+}
+
+void EvalOverlayItem::rescanRange() {
+    // Полный проход — только после смены стороны / метрики или ухода клетки с края шкалы, не на каждый кадр.
+    lo_ = std::numeric_limits<long long>::max();
+    hi_ = std::numeric_limits<long long>::min();
+    for (const auto& [t, tile] : tiles_) {
+        (void)t;
+        for (const auto& [c, cell] : tile) {
+            (void)c;
+            if (!cell.of(player_).legal) continue;
+            const long long v = valueOf(cell);
+            lo_ = std::min(lo_, v);
+            hi_ = std::max(hi_, v);
+        }
+    }
+    if (lo_ > hi_) {
+        lo_ = 0;
+        hi_ = -1;
+    }
+    rangeStale_ = false;
+}
+
+void EvalOverlayItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    if (cellCount_ == 0) return;
+
+    const QRectF exposed = option->exposedRect.intersected(rect_);
+    if (!exposed.isValid() || exposed.isEmpty()) return;
+
+    if (rangeStale_) rescanRange();
+    if (lo_ > hi_) return;
+
+    // Оценки хода различаются на порядки (выигрыш, блок, мелкие прибавки): шкала логарифмическая.
+    const double span = std::log1p(static_cast<double>(hi_ - lo_));
+    painter->setPen(Qt::NoPen);
+
+    tiles_.forEachVisible(exposed, cellSize_, [&](engine::Coord, const Tile& tile) {
+        for (const auto& [c, cell] : tile) {
+            if (!cell.of(player_).legal) continue;
+            const QRectF r = cellRect(c);
+            if (!r.intersects(exposed)) continue;
+
+            const double t = span > 0 ? std::log1p(static_cast<double>(valueOf(cell) - lo_)) / span : 0.0;
+            QColor color = QColor::fromHsvF(0.66 * (1.0 - t), 0.85, 1.0);
+            color.setAlphaF(0.25 + 0.35 * t);
+            painter->fillRect(r, color);
+        }
+    });
+}
@@ -0,0 +1,64 @@
+#ifndef TIKTAKTOE_EVALOVERLAYITEM_H
+#define TIKTAKTOE_EVALOVERLAYITEM_H
+#pragma once
+
+#include <QGraphicsItem>
+#include <QRectF>
+
+#include <unordered_map>
+#include <vector>
+
+#include <engine/Board.h>
+
+#include "EvalWorker.h"
+#include "TileIndex.h"
+
+// Heatmap of the AI's first-ply view under the stones: every scored cell is tinted from blue (worst scored)
+// to red (best) by the chosen metric, seen by the side to move. Scores arrive in batches and replace old ones.
+// Cells are bucketed in a TileIndex like the stones, and the color scale is kept up to date as scores change, so a
+// repaint costs what is on screen rather than the size of the frontier.
+class EvalOverlayItem : public QGraphicsItem {
+public:
+    static constexpr int kTileCells = 16;
+
+    enum class Metric { MoveScore, Own, Opponent };
+
+    EvalOverlayItem(const QRectF& rect, int cellSizePx);
+
+    QRectF boundingRect() const override { return rect_; }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    void setRect(const QRectF& r);
+    void setMetric(Metric m);
+    void setPlayer(engine::Player p);
+
+    void setScores(const std::vector<EvalCell>& cells);
+    void removeCell(engine::Coord c);
+    void clear();
+
+private:
+    using Tile = std::unordered_map<engine::Coord, EvalCell, engine::CoordHash>;
+    using Tiles = TileIndex<Tile, kTileCells>;
+
+    long long valueOf(const EvalCell& cell) const;
+    QRectF cellRect(engine::Coord c) const;
+
+    // Scale edges of the shown metric; a change that may move an edge inward marks them stale.
+    void widenRange(const EvalCell& cell);
+    void dropFromRange(const EvalCell& cell);
+    void rescanRange();
+
+    QRectF rect_;
+    int cellSize_ = 40;
+    Metric metric_ = Metric::MoveScore;
+    engine::Player player_ = engine::Player::X;
+
+    Tiles tiles_; // non-empty tiles only
+    std::size_t cellCount_ = 0;
+
+    long long lo_ = 0;
+    long long hi_ = -1; // lo_ > hi_: no legal cell
+    bool rangeStale_ = false;
+};
+
+#endif
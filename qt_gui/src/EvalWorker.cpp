@@ -0,0 +1,129 @@
+#include "EvalWorker.h"
+
+#include <QThread>
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+
+// Клеток в одной пачке: оверлей уточняется на глазах, а сигналов немного даже на больших досках.
+constexpr std::size_t kChunkCells = 256;
+
+// Подсказки не должны заставлять ждать: поиск для них ограничен по времени.
+constexpr int kHintsTimeMs = 1000;
+
+}
+
+EvalWorker::EvalWorker(QObject* parent)
+    : QObject(parent) {}
+
+void EvalWorker::evaluate(const Request& r) {
+    const engine::GameState& state = *r.state;
+    for (std::size_t i = 0; i < r.cells.size() && !r.stop->load(); i += kChunkCells) {
+        EvalBatch b;
+        b.id = r.id;
+        const std::size_t end = std::min(r.cells.size(), i + kChunkCells);
+        b.cells.reserve(end - i);
+        for (std::size_t k = i; k < end; ++k) {
+            const engine::Coord c = r.cells[k];
+            b.cells.push_back(EvalCell{c, ai_.scoreCell(state, engine::Player::X, c), ai_.scoreCell(state, engine::Player::O, c)});
+        }
+        emit evaluated(b);
+    }
+}
+
+void EvalWorker::analyse(const Request& r, engine::Player player, int count, int radius) {
+    EvalHints h;
+    h.id = r.id;
+    h.moveCount = r.state->moveCount();
+    if (!r.stop->load()) {
+        engine::SimpleAI::Settings s;
+        s.candidateRadius = radius;
+        engine::SimpleAI ai(s);
+        engine::SearchLimits limits = engine::SearchLimits::within(std::chrono::milliseconds(kHintsTimeMs));
+        limits.stop = r.stop.get();
+        h.lines = ai.analyse(*r.state, player, static_cast<std::size_t>(std::max(0, count)), limits);
+    }
+    emit analysed(h);
+}
+
+EvalRunner::EvalRunner(QObject* parent)
+    : QObject(parent) {
+    qRegisterMetaType<EvalBatch>();
+    qRegisterMetaType<EvalHints>();
+
+    thread_ = new QThread(this);
+    thread_->setObjectName("eval");
+
+    worker_ = new EvalWorker;
+    worker_->moveToThread(thread_);
+    connect(thread_, &QThread::finished, worker_, &QObject::deleteLater);
+    connect(worker_, &EvalWorker::evaluated, this, &EvalRunner::onWorkerEvaluated);
+    connect(worker_, &EvalWorker::analysed, this, &EvalRunner::onWorkerAnalysed);
+
+    thread_->start(QThread::LowPriority); // оверлей не должен отнимать время у поиска AI
+}
+
+EvalRunner::~EvalRunner() {
+    cancel();
+    cancelAnalysis();
+    thread_->quit();
+    thread_->wait();
+}
+
+void EvalRunner::evaluate(const engine::GameState& game, std::vector<engine::Coord> cells) {
+    cancel();
+    if (cells.empty()) return;
+
+    EvalWorker::Request r;
+    r.id = nextId_++;
+    r.state = std::make_shared<const engine::GameState>(game);
+    r.cells = std::move(cells);
+    r.stop = std::make_shared<std::atomic<bool>>(false);
+    current_ = r.id;
+    stop_ = r.stop;
+
+    EvalWorker* w = worker_;
+    QMetaObject::invokeMethod(worker_, [w, r = std::move(r)]() { w->evaluate(r); }, Qt::QueuedConnection);
+}
+
+void EvalRunner::cancel() {
+    if (stop_) stop_->store(true);
+    stop_.reset();
+    current_ = 0;
+}
+
+void EvalRunner::analyse(const engine::GameState& game, int count, int radius) {
+    cancelAnalysis();
+    if (count <= 0 || game.isGameOver()) return;
+
+    EvalWorker::Request r;
+    r.id = nextId_++;
+    r.state = std::make_shared<const engine::GameState>(game);
+    r.stop = std::make_shared<std::atomic<bool>>(false);
+    hintsId_ = r.id;
+    hintsStop_ = r.stop;
+
+    EvalWorker* w = worker_;
+    const engine::Player player = game.currentPlayer();
+    QMetaObject::invokeMethod(worker_, [w, r, player, count, radius]() { w->analyse(r, player, count, radius); },
+                              Qt::QueuedConnection);
+}
+
+void EvalRunner::cancelAnalysis() {
+    if (hintsStop_) hintsStop_->store(true);
+    hintsStop_.reset();
+    hintsId_ = 0;
+}
+
+void EvalRunner::onWorkerEvaluated(const EvalBatch& b) {
+    if (b.id == current_) emit evaluated(b);
+}
+
+void EvalRunner::onWorkerAnalysed(const EvalHints& h) {
+    if (h.id != hintsId_) return;
+    hintsId_ = 0;
+    hintsStop_.reset();
+    emit analysed(h);
+}
@@ -0,0 +1,102 @@
+#ifndef TIKTAKTOE_EVALWORKER_H
+#define TIKTAKTOE_EVALWORKER_H
+#pragma once
+
+#include <QMetaType>
+#include <QObject>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <engine/AI.h>
+#include <engine/GameState.h>
+
+class QThread;
+
+// Scores of one cell for both players.
+struct EvalCell {
+    engine::Coord c{};
+    engine::SimpleAI::CellScore x;
+    engine::SimpleAI::CellScore o;
+
+    const engine::SimpleAI::CellScore& of(engine::Player p) const noexcept { return p == engine::Player::O ? o : x; }
+};
+
+struct EvalBatch {
+    quint64 id = 0;
+    std::vector<EvalCell> cells;
+};
+
+// Top moves of one analysis search (numbered hints), best first.
+struct EvalHints {
+    quint64 id = 0;
+    int moveCount = 0; // of the analysed position
+    std::vector<engine::SimpleAI::AnalysedMove> lines;
+};
+
+Q_DECLARE_METATYPE(EvalBatch)
+Q_DECLARE_METATYPE(EvalHints)
+
+// Lives on the evaluation thread: scores the cells of a request in order, a chunk per emitted batch, and runs
+// multi-PV analyses for hints.
+class EvalWorker : public QObject {
+    Q_OBJECT
+public:
+    struct Request {
+        quint64 id = 0;
+        std::shared_ptr<const engine::GameState> state;
+        std::vector<engine::Coord> cells;
+        std::shared_ptr<std::atomic<bool>> stop;
+    };
+
+    explicit EvalWorker(QObject* parent = nullptr);
+
+    void evaluate(const Request& r);
+    void analyse(const Request& r, engine::Player player, int count, int radius);
+
+signals:
+    void evaluated(const EvalBatch& b);
+    void analysed(const EvalHints& h);
+
+private:
+    engine::SimpleAI ai_;
+};
+
+// GUI-side handle of the evaluation thread, separate from the AI thread so the overlay refines while the AI
+// searches. evaluate() drops the request still running; only batches of the latest one are re-emitted.
+class EvalRunner : public QObject {
+    Q_OBJECT
+public:
+    explicit EvalRunner(QObject* parent = nullptr);
+    ~EvalRunner() override;
+
+    void evaluate(const engine::GameState& game, std::vector<engine::Coord> cells);
+    void cancel();
+
+    // Best `count` moves of the side to move from one search with the given candidate radius; a new call drops
+    // the previous one.
+    void analyse(const engine::GameState& game, int count, int radius);
+    void cancelAnalysis();
+
+signals:
+    void evaluated(const EvalBatch& b);
+    void analysed(const EvalHints& h);
+
+private slots:
+    void onWorkerEvaluated(const EvalBatch& b);
+    void onWorkerAnalysed(const EvalHints& h);
+
+private:
+    QThread* thread_ = nullptr;
+    EvalWorker* worker_ = nullptr;
+
+    quint64 nextId_ = 1;
+    quint64 current_ = 0;
+    std::shared_ptr<std::atomic<bool>> stop_;
+
+    quint64 hintsId_ = 0;
+    std::shared_ptr<std::atomic<bool>> hintsStop_;
+};
+
+#endif
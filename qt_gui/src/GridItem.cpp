@@ -5,9 +5,17 @@
 
 #include <cmath>
 
+namespace {
+
+// Мельче этого (пикселей экрана на клетку) линии сливаются в серую заливку: не рисуем их вовсе.
+constexpr qreal kLinesMinPixels = 6.0;
+
+}
+
 GridItem::GridItem(const QRectF& rect, int cellSizePx, bool drawBorder)
     : rect_(rect), cellSize_(std::max(2, cellSizePx)), drawBorder_(drawBorder) {
     setZValue(0);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption); // exposedRect = только перерисовываемая часть
 }
 
 void GridItem::setRect(const QRectF& r) {
@@ -29,6 +37,18 @@ void GridItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
     QRectF exposed = option->exposedRect.intersected(rect_);
     if (!exposed.isValid() || exposed.isEmpty()) return;
 
+    const qreal cellPixels = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform()) * cellSize_;
+    if (cellPixels >= kLinesMinPixels) paintLines(painter, exposed);
+
+    if (drawBorder_) {
+        QPen borderPen(Qt::gray);
+        borderPen.setWidthF(0.0);
+        painter->setPen(borderPen);
+        painter->drawRect(rect_);
+    }
+}
+
+void GridItem::paintLines(QPainter* painter, const QRectF& exposed) const {
     QPen gridPen(Qt::lightGray);
     gridPen.setWidthF(0.0);
     painter->setPen(gridPen);
@@ -51,11 +71,4 @@ void GridItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option,
     for (qreal y = startY; y <= endY; y += cs) {
         painter->drawLine(QPointF(left, y), QPointF(right, y));
     }
-
-    if (drawBorder_) {
-        QPen borderPen(Qt::gray);
-        borderPen.setWidthF(0.0);
-        painter->setPen(borderPen);
-        painter->drawRect(rect_);
-    }
 }
@@ -5,6 +5,7 @@
 #include <QGraphicsItem>
 #include <QRectF>
 
+// Cell grid; zoomed out below a few pixels per cell only the border is drawn.
 class GridItem : public QGraphicsItem {
 public:
     GridItem(const QRectF& rect, int cellSizePx, bool drawBorder);
@@ -17,6 +18,8 @@ public:
     void setDrawBorder(bool b);
 
 private:
+    void paintLines(QPainter* painter, const QRectF& exposed) const;
+
     QRectF rect_;
     int cellSize_ = 40;
     bool drawBorder_ = true;
@@ -0,0 +1,59 @@
+#include "HintLayerItem.h"
+
+#include <QColor>
+#include <QFont>
+#include <QPainter>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+
+HintLayerItem::HintLayerItem(const QRectF& rect, int cellSizePx)
+    : rect_(rect), cellSize_(std::max(2, cellSizePx)) {
+    setZValue(3); // над камнями, под подсветкой последнего хода
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+void HintLayerItem::setRect(const QRectF& r) {
+    prepareGeometryChange();
+    rect_ = r;
+}
+
+QRectF HintLayerItem::cellRect(engine::Coord c) const {
+    return QRectF(c.x * cellSize_, c.y * cellSize_, cellSize_, cellSize_);
+}
+
+void HintLayerItem::setHints(const std::vector<engine::SimpleAI::AnalysedMove>& lines) {
+    clear();
+    lines_ = lines;
+    for (const auto& line : lines_) update(cellRect(line.move));
+}
+
+void HintLayerItem::clear() {
+    for (const auto& line : lines_) update(cellRect(line.move));
+    lines_.clear();
+}
+
+void HintLayerItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    if (lines_.empty()) return;
+
+    painter->setRenderHint(QPainter::Antialiasing, true);
+    QFont font = painter->font();
+    font.setBold(true);
+    font.setPixelSize(std::max(6, cellSize_ / 2));
+    painter->setFont(font);
+
+    // Рисуем с последнего: номер 1 оказывается сверху, если клетки совпали бы по ошибке.
+    for (std::size_t i = lines_.size(); i-- > 0;) {
+        const QRectF cell = cellRect(lines_[i].move);
+        if (!cell.intersects(option->exposedRect)) continue;
+
+        const qreal m = cellSize_ * 0.12;
+        const QRectF r = cell.adjusted(m, m, -m, -m);
+        painter->setPen(QPen(QColor(20, 140, 60), 2.0));
+        painter->setBrush(QColor(60, 200, 100, i == 0 ? 170 : 90));
+        painter->drawEllipse(r);
+
+        painter->setPen(Qt::black);
+        painter->drawText(r, Qt::AlignCenter, QString::number(i + 1));
+    }
+}
@@ -0,0 +1,32 @@
+#ifndef TIKTAKTOE_HINTLAYERITEM_H
+#define TIKTAKTOE_HINTLAYERITEM_H
+#pragma once
+
+#include <QGraphicsItem>
+#include <QRectF>
+
+#include <vector>
+
+#include <engine/AI.h>
+
+// Numbered hint markers on the board, 1 being the move the AI would play. Replaced as a whole by every analysis.
+class HintLayerItem : public QGraphicsItem {
+public:
+    HintLayerItem(const QRectF& rect, int cellSizePx);
+
+    QRectF boundingRect() const override { return rect_; }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    void setRect(const QRectF& r);
+    void setHints(const std::vector<engine::SimpleAI::AnalysedMove>& lines);
+    void clear();
+
+private:
+    QRectF cellRect(engine::Coord c) const;
+
+    QRectF rect_;
+    int cellSize_ = 40;
+    std::vector<engine::SimpleAI::AnalysedMove> lines_;
+};
+
+#endif
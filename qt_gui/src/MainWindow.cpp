@@ -1,52 +1,113 @@
 #include "MainWindow.h"
 
 #include "BoardView.h"
+#include "EvalOverlayItem.h"
 #include "GameOverDialog.h"
 #include "GridItem.h"
-#include "MarkItem.h"
+#include "HintLayerItem.h"
+#include "MinimapWidget.h"
 #include "SettingsPanel.h"
+#include "StoneLayerItem.h"
 
 #include <QDockWidget>
 #include <QGraphicsRectItem>
 #include <QMessageBox>
+#include <QScreen>
 #include <QStatusBar>
+#include <QStringList>
 #include <QTimer>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
 MainWindow::MainWindow(const AppConfig& cfg, QWidget* parent)
     : QMainWindow(parent),
       cfg_(cfg),
-      game_(),
-      ai_(engine::SimpleAI::Settings{cfg.aiCandidateRadius, 600, 0}) {
+      game_() {
     setWindowTitle("Advanced Tic-Tac-Toe (Qt6)");
 
     cellSize_ = cfg_.cellSizePx;
 
     scene_ = new QGraphicsScene(this);
+    scene_->setItemIndexMethod(QGraphicsScene::NoIndex); // предметов единицы: сетка, слой камней, подсветка
 
     view_ = new BoardView(this);
     view_->setScene(scene_);
     view_->setCellSize(cellSize_);
     setCentralWidget(view_);
 
+    ai_ = new AiRunner(this);
+    connect(ai_, &AiRunner::progressed, this, &MainWindow::onAiProgress);
+    connect(ai_, &AiRunner::moveReady, this, &MainWindow::onAiMoveReady);
+
+    autoplayTimer_ = new QTimer(this);
+    connect(autoplayTimer_, &QTimer::timeout, this, &MainWindow::onAutoplayFrame);
+
+    eval_ = new EvalRunner(this);
+    connect(eval_, &EvalRunner::evaluated, this, &MainWindow::onEvalBatch);
+    evalTimer_ = new QTimer(this);
+    evalTimer_->setSingleShot(true);
+    evalTimer_->setInterval(0);
+    connect(evalTimer_, &QTimer::timeout, this, &MainWindow::sendEvalRequest);
+    connect(eval_, &EvalRunner::analysed, this, &MainWindow::onHintsReady);
+    hintsTimer_ = new QTimer(this);
+    hintsTimer_->setSingleShot(true);
+    hintsTimer_->setInterval(0);
+    connect(hintsTimer_, &QTimer::timeout, this, &MainWindow::sendHintsRequest);
+
     settings_ = new SettingsPanel(this);
     auto* dock = new QDockWidget("Settings", this);
     dock->setWidget(settings_);
     addDockWidget(Qt::LeftDockWidgetArea, dock);
 
+    minimap_ = new MinimapWidget(this);
+    auto* minimapDock = new QDockWidget("Minimap", this);
+    minimapDock->setWidget(minimap_);
+    addDockWidget(Qt::RightDockWidgetArea, minimapDock);
+
     connect(view_, &BoardView::cellClicked, this, &MainWindow::onCellClicked);
+    connect(view_, &BoardView::viewportChanged, this, &MainWindow::onViewportChanged);
+    connect(minimap_, &MinimapWidget::jumpRequested, this, &MainWindow::onMinimapJump);
     connect(settings_, &SettingsPanel::newGameRequested, this, &MainWindow::onNewGameRequested);
     connect(settings_, &SettingsPanel::undoRequested, this, &MainWindow::onUndoRequested);
     connect(settings_, &SettingsPanel::redoRequested, this, &MainWindow::onRedoRequested);
     connect(settings_, &SettingsPanel::nextTurnRequested, this, &MainWindow::onNextTurnRequested);
     connect(settings_, &SettingsPanel::resetViewRequested, this, &MainWindow::onResetViewRequested);
+    connect(settings_, &SettingsPanel::cancelAiRequested, this, &MainWindow::onCancelAiRequested);
+    connect(settings_, &SettingsPanel::ponderToggled, this, &MainWindow::onPonderToggled);
+    connect(settings_, &SettingsPanel::autoplayToggled, this, &MainWindow::onAutoplayToggled);
+    connect(settings_, &SettingsPanel::autoplaySpeedChanged, this, &MainWindow::onAutoplaySpeedChanged);
+    connect(settings_, &SettingsPanel::evalOverlayChanged, this, &MainWindow::onEvalOverlayChanged);
+    connect(settings_, &SettingsPanel::hintsChanged, this, &MainWindow::onHintsChanged);
 
     settings_->setRulesToUi(cfg_.rules);
     settings_->setAiSettings(cfg_.aiEnabled, cfg_.aiPlayer, cfg_.aiCandidateRadius);
+    settings_->setAiPonder(cfg_.aiPonder);
 
     aiEnabled_ = cfg_.aiEnabled;
     aiPlayer_ = cfg_.aiPlayer;
     aiRadius_ = cfg_.aiCandidateRadius;
 
+    if (!cfg_.tablebaseFile.isEmpty()) {
+        auto tb = std::make_shared<engine::Tablebase>();
+        if (tb->open(cfg_.tablebaseFile.toStdString())) {
+            tablebase_ = std::move(tb);
+        } else {
+            QMessageBox::warning(this, "Tablebase", QString("Cannot open tablebase: %1").arg(cfg_.tablebaseFile));
+        }
+    }
+
+    if (!cfg_.openingBookFile.isEmpty()) {
+        auto book = std::make_shared<engine::OpeningBook>();
+        if (book->open(cfg_.openingBookFile.toStdString())) {
+            openingBook_ = std::move(book);
+        } else {
+            QMessageBox::warning(this, "Opening book", QString("Cannot open opening book: %1").arg(cfg_.openingBookFile));
+        }
+    }
+
+    game_.subscribe([this](const engine::ChangeBatch& b) { onGameChanged(b); }); // сцена и виджеты уже созданы
     startNewGame(settings_->rulesFromUi());
 
     statusBar()->showMessage("Ready");
@@ -57,6 +118,8 @@ void MainWindow::onNewGameRequested() {
 }
 
 void MainWindow::startNewGame(const engine::RuleSet& rules) {
+    cancelAiSearch();
+
     engine::RuleSet r = rules;
     const auto warnings = r.validateAndFix();
     if (!warnings.empty()) {
@@ -66,57 +129,66 @@ void MainWindow::startNewGame(const engine::RuleSet& rules) {
         QMessageBox::information(this, "Rule warnings", msg.trimmed());
     }
 
-    game_.newGame(r, engine::GameState::createBoard(r));
-
     view_->setFiniteBounds(
         r.topology == engine::BoardTopology::Finite ? r.width : 0,
         r.topology == engine::BoardTopology::Finite ? r.height : 0
     );
 
+    game_.newGame(r, engine::GameState::createBoard(r)); // сброс в ленте изменений пересобирает сцену
+
     aiEnabled_ = settings_->aiEnabled();
     aiPlayer_ = settings_->aiPlayer();
     aiRadius_ = settings_->aiCandidateRadius();
-    ai_ = engine::SimpleAI(engine::SimpleAI::Settings{aiRadius_, 600, 0});
+    ai_->configure(engine::SimpleAI::Settings{aiRadius_, 600, 0}, tablebase_, openingBook_);
+    game_.setFrontierRadius(aiRadius_); // кандидаты AI берутся из фронта того же радиуса
 
-    rebuildScene();
     updateUi();
     ensureAiMoveIfNeeded();
 }
 
 void MainWindow::rebuildScene() {
     scene_->clear();
-    markItems_.clear();
+
+    // Полный обход камней — только здесь, дальше рамка растёт по ходам.
+    stoneBounds_ = QRect();
+    for (const auto& [c, p] : game_.board().occupied()) {
+        (void)p;
+        stoneBounds_ |= QRect(c.x, c.y, 1, 1);
+    }
 
     scene_->setSceneRect(boardSceneRect());
 
     grid_ = new GridItem(scene_->sceneRect(), cellSize_, game_.rules().topology == engine::BoardTopology::Finite);
     scene_->addItem(grid_);
 
+    stones_ = new StoneLayerItem(scene_->sceneRect(), cellSize_);
+    scene_->addItem(stones_);
+
+    evalOverlay_ = new EvalOverlayItem(scene_->sceneRect(), cellSize_);
+    evalOverlay_->setVisible(evalOverlayOn());
+    if (evalOverlayOn()) evalOverlay_->setMetric(static_cast<EvalOverlayItem::Metric>(settings_->evalOverlay() - 1));
+    evalOverlay_->setPlayer(game_.currentPlayer());
+    scene_->addItem(evalOverlay_);
+
+    hints_ = new HintLayerItem(scene_->sceneRect(), cellSize_);
+    scene_->addItem(hints_);
+
     lastMoveHighlight_ = scene_->addRect(QRectF(), QPen(QColor(255, 170, 0), 2.0));
     lastMoveHighlight_->setZValue(5);
     lastMoveHighlight_->hide();
 
     syncSceneWithBoard();
+    minimap_->setBoard(game_.board());
+    minimap_->setArea(boardCells());
     view_->resetViewToRect(scene_->sceneRect());
+    refreshEvalAll();
+    invalidateHints();
 }
 
 void MainWindow::syncSceneWithBoard() {
-    const auto occ = game_.board().occupied();
-    for (const auto& [coord, p] : occ) {
-        const QRectF rect(coord.x * cellSize_, coord.y * cellSize_, cellSize_, cellSize_);
-        auto* item = new MarkItem(p, rect);
-        scene_->addItem(item);
-        markItems_[coord] = item;
-    }
-
-    if (game_.lastMove()) {
-        const auto lm = game_.lastMove().value();
-        const QRectF rect(lm.x * cellSize_, lm.y * cellSize_, cellSize_, cellSize_);
-        lastMoveHighlight_->setRect(rect.adjusted(1, 1, -1, -1));
-        lastMoveHighlight_->show();
-    } else {
-        lastMoveHighlight_->hide();
-    }
+    // Камни слой читает с доски партии сам, ему нужен только указатель на неё.
+    stones_->setBoard(&game_.board());
+    showLastMove();
 }
 
 void MainWindow::updateUi() {
@@ -124,7 +196,9 @@ void MainWindow::updateUi() {
 
     const bool aiVsAi = isAiVsAiModeActive();
     settings_->setNextTurnVisible(aiVsAi);
-    settings_->setNextTurnEnabled(aiVsAi && !game_.isGameOver());
+    settings_->setNextTurnEnabled(aiVsAi && !game_.isGameOver() && !ai_->isBusy() && !autoplay_);
+    settings_->setAutoplayVisible(aiVsAi);
+    if (evalOverlay_) evalOverlay_->setPlayer(game_.currentPlayer());
 }
 bool MainWindow::isAiVsAiModeActive() const {
     // Convention: aiEnabled=true + aiPlayer=None => both sides are controlled by AI.
@@ -149,20 +223,6 @@ void MainWindow::onCellClicked(int x, int y) {
         return;
     }
 
-    const engine::Player p = game_.board().get(c);
-    const QRectF rect(x * cellSize_, y * cellSize_, cellSize_, cellSize_);
-    auto* item = new MarkItem(p, rect);
-    scene_->addItem(item);
-    markItems_[c] = item;
-
-    if (lastMoveHighlight_) {
-        lastMoveHighlight_->setRect(rect.adjusted(1, 1, -1, -1));
-        lastMoveHighlight_->show();
-    }
-
-    updateSceneRectForTopology();
-    updateUi();
-
     if (game_.isGameOver()) {
         GameOverDialog dlg(game_, this);
         dlg.exec();
@@ -173,52 +233,18 @@ void MainWindow::onCellClicked(int x, int y) {
 }
 
 void MainWindow::onUndoRequested() {
-    const auto last = game_.lastMove(); // last move before undo
-    if (!game_.undo()) return;
-
-    if (last) {
-        auto it = markItems_.find(*last);
-        if (it != markItems_.end()) {
-            scene_->removeItem(it->second);
-            delete it->second;
-            markItems_.erase(it);
-        }
-    }
-
-    if (game_.lastMove()) {
-        const auto lm = game_.lastMove().value();
-        const QRectF rect(lm.x * cellSize_, lm.y * cellSize_, cellSize_, cellSize_);
-        lastMoveHighlight_->setRect(rect.adjusted(1, 1, -1, -1));
-        lastMoveHighlight_->show();
-    } else {
-        lastMoveHighlight_->hide();
-    }
+    if (!game_.canUndo()) return;
+    cancelAiSearch(); // поиск шёл по позиции, которой больше нет
 
-    updateSceneRectForTopology();
-    updateUi();
+    if (!game_.undo()) return;
+    ponderIfHumanToMove();
 }
 
 void MainWindow::onRedoRequested() {
+    if (!game_.canRedo()) return;
+    cancelAiSearch();
     if (!game_.redo()) return;
 
-    if (game_.lastMove()) {
-        const auto lm = game_.lastMove().value();
-        if (markItems_.find(lm) == markItems_.end()) {
-            const engine::Player p = game_.board().get(lm);
-            const QRectF rect(lm.x * cellSize_, lm.y * cellSize_, cellSize_, cellSize_);
-            auto* item = new MarkItem(p, rect);
-            scene_->addItem(item);
-            markItems_[lm] = item;
-        }
-        lastMoveHighlight_->setRect(QRectF(lm.x * cellSize_, lm.y * cellSize_, cellSize_, cellSize_).adjusted(1, 1, -1, -1));
-        lastMoveHighlight_->show();
-    } else {
-        lastMoveHighlight_->hide();
-    }
-
-    updateSceneRectForTopology();
-    updateUi();
-
     if (game_.isGameOver()) {
         GameOverDialog dlg(game_, this);
         dlg.exec();
@@ -242,142 +268,425 @@ void MainWindow::onNextTurnRequested() {
         return;
     }
 
-    // Через event loop, чтобы UI не подвисал и было похоже на остальные AI-вызовы
-    QTimer::singleShot(0, this, [this]() {
-        if (!(aiEnabled_ && aiPlayer_ == engine::Player::None)) return;
-        if (game_.isGameOver()) return;
+    if (ai_->isBusy()) {
+        statusBar()->showMessage("AI is already thinking.", 2000);
+        return;
+    }
 
-        const engine::Player p = game_.currentPlayer();
+    requestAiMove(game_.currentPlayer());
+}
 
-        auto mv = ai_.chooseMove(game_, p);
-        if (!mv) {
-            statusBar()->showMessage("AI: no legal move found.", 2000);
-            return;
-        }
+void MainWindow::ensureAiMoveIfNeeded() {
+    if (!aiEnabled_) return;
+    if (game_.isGameOver()) return;
 
-        const auto res = game_.tryMakeMove(*mv);
-        if (!res.ok) {
-            statusBar()->showMessage(
-                QString("AI move failed: %1").arg(QString::fromStdString(res.message)),
-                2000
-            );
-            return;
-        }
+    // In AI vs AI mode we advance moves manually with the "Next Turn" button.
+    if (isAiVsAiModeActive()) return;
 
-        const engine::Coord c = *mv;
-        const engine::Player placed = game_.board().get(c);
-        const QRectF rect(c.x * cellSize_, c.y * cellSize_, cellSize_, cellSize_);
+    if (aiPlayer_ == engine::Player::None) return;
+    if (game_.currentPlayer() != aiPlayer_) {
+        ponderIfHumanToMove();
+        return;
+    }
 
-        auto* item = new MarkItem(placed, rect);
-        scene_->addItem(item);
-        markItems_[c] = item;
+    requestAiMove(aiPlayer_);
+}
 
-        if (lastMoveHighlight_) {
-            lastMoveHighlight_->setRect(rect.adjusted(1, 1, -1, -1));
-            lastMoveHighlight_->show();
-        }
+void MainWindow::requestAiMove(engine::Player aiPlayer) {
+    if (!aiEnabled_) return;
+    if (game_.isGameOver()) return;
+    if (aiPlayer == engine::Player::None) return;
+    if (game_.currentPlayer() != aiPlayer) return;
+    if (ai_->isBusy()) return;
 
-        updateSceneRectForTopology();
-        updateUi();
+    // Поиск идёт по копии партии в потоке AI, окно продолжает перерисовываться.
+    ai_->start(game_, aiPlayer);
+    settings_->setAiThinking(true);
+    settings_->setNextTurnEnabled(false);
+    statusBar()->showMessage(QString("AI (%1) is thinking...").arg(aiPlayer == engine::Player::X ? "X" : "O"));
+}
+
+void MainWindow::cancelAiSearch() {
+    stopAutoplay();
+    const bool busy = ai_->isBusy();
+    ai_->cancel();
+    if (!busy) return;
+    settings_->setAiThinking(false);
+    statusBar()->showMessage("AI search cancelled.", 1500);
+}
+
+void MainWindow::ponderIfHumanToMove() {
+    if (!aiEnabled_ || aiPlayer_ == engine::Player::None || !settings_->aiPonder()) return;
+    if (game_.isGameOver() || game_.currentPlayer() == aiPlayer_ || ai_->isBusy()) return;
+
+    // Пока человек думает, AI готовит ответы на его вероятные ходы.
+    ai_->ponder(game_, aiPlayer_);
+}
+
+void MainWindow::onPonderToggled(bool on) {
+    if (on) {
+        ponderIfHumanToMove();
+    } else {
+        ai_->stopPondering();
+    }
+}
+
+void MainWindow::startAutoplay() {
+    if (!isAiVsAiModeActive() || game_.isGameOver() || autoplay_) return;
+    cancelAiSearch();
+
+    autoplay_ = std::make_shared<AutoplayFeed>();
+    autoplay_->movesPerSecond.store(settings_->autoplaySpeed());
+    ai_->autoplay(game_, autoplay_);
+
+    // Ходы забираются раз в кадр экрана: сколько бы их ни пришло, сцена и панель обновляются один раз.
+    const qreal hz = screen() ? screen()->refreshRate() : 60.0;
+    autoplayTimer_->start(std::max(1, static_cast<int>(1000.0 / std::max<qreal>(hz, 1.0))));
+
+    settings_->setAutoplayRunning(true);
+    updateUi();
+    statusBar()->showMessage("Autoplay running...");
+}
+
+void MainWindow::stopAutoplay() {
+    if (!autoplay_) return;
+    ai_->cancel(); // останавливает и партию в потоке AI
+    autoplay_.reset();
+    autoplayTimer_->stop();
+    settings_->setAutoplayRunning(false);
+    updateUi();
+    statusBar()->clearMessage();
+}
+
+void MainWindow::onAutoplayToggled(bool on) {
+    if (on) {
+        startAutoplay();
+        if (!autoplay_) settings_->setAutoplayRunning(false); // не тот режим или партия окончена
+    } else {
+        stopAutoplay();
+    }
+}
+
+void MainWindow::onAutoplaySpeedChanged(int movesPerSecond) {
+    if (autoplay_) autoplay_->movesPerSecond.store(movesPerSecond);
+}
+
+void MainWindow::onAutoplayFrame() {
+    if (!autoplay_) return;
+
+    bool done = false;
+    const std::vector<engine::Coord> moves = autoplay_->take(done);
 
+    // Все ходы кадра — одна пачка изменений: рамка, подсветка и панель обновляются один раз.
+    if (game_.playMoves(moves) < moves.size()) done = true;
+
+    if (done || game_.isGameOver()) {
+        stopAutoplay();
         if (game_.isGameOver()) {
             GameOverDialog dlg(game_, this);
             dlg.exec();
         }
-    });
+    }
 }
 
-void MainWindow::ensureAiMoveIfNeeded() {
-    if (!aiEnabled_) return;
-    if (game_.isGameOver()) return;
+void MainWindow::showLastMove() {
+    if (game_.lastMove()) {
+        const auto lm = game_.lastMove().value();
+        lastMoveHighlight_->setRect(QRectF(lm.x * cellSize_, lm.y * cellSize_, cellSize_, cellSize_).adjusted(1, 1, -1, -1));
+        lastMoveHighlight_->show();
+    } else {
+        lastMoveHighlight_->hide();
+    }
+}
 
-    // In AI vs AI mode we advance moves manually with the "Next Turn" button.
-    if (isAiVsAiModeActive()) return;
+void MainWindow::onCancelAiRequested() {
+    if (!ai_->isBusy()) return;
+    ai_->finishNow();
+    statusBar()->showMessage("Stopping AI search...");
+}
 
-    if (aiPlayer_ == engine::Player::None) return;
-    if (game_.currentPlayer() != aiPlayer_) return;
+void MainWindow::onAiProgress(const AiProgress& p) {
+    const engine::SearchProgress& s = p.search;
+    const double secs = std::chrono::duration<double>(s.elapsed).count();
+
+    QString text = QString::fromStdString(engine::toString(s.stage));
+    if (s.ply > 0) text += QString(", ply %1: %2/%3 moves").arg(s.ply).arg(s.done).arg(s.total);
+    text += QString(", %1 nodes, %2 s").arg(s.nodes).arg(secs, 0, 'f', 1);
+    if (s.best) text += QString("\nBest so far: (%1,%2)").arg(s.best->x).arg(s.best->y);
 
-    QTimer::singleShot(0, this, [this]() { performAiMove(aiPlayer_); });
+    settings_->setAiProgress(text, static_cast<int>(s.done), static_cast<int>(s.total));
 }
 
-void MainWindow::performAiMove(engine::Player aiPlayer) {
-    if (!aiEnabled_) return;
-    if (game_.isGameOver()) return;
-    if (aiPlayer == engine::Player::None) return;
-    if (game_.currentPlayer() != aiPlayer) return;
+void MainWindow::onAiMoveReady(const AiResult& r) {
+    settings_->setAiThinking(false);
+    statusBar()->clearMessage();
 
-    auto mv = ai_.chooseMove(game_, aiPlayer);
-    if (!aiEnabled_ || game_.isGameOver() || game_.currentPlayer() != aiPlayer_) return;
+    // Запрос отменяется при любом изменении партии, но позицию всё равно сверяем.
+    if (!aiEnabled_ || game_.isGameOver() || game_.currentPlayer() != r.player || game_.moveCount() != r.moveCount) {
+        updateUi();
+        return;
+    }
 
-    if (!mv) {
+    if (!r.move) {
         statusBar()->showMessage("AI: no legal move found.", 2000);
+        updateUi();
         return;
     }
 
-    const auto res = game_.tryMakeMove(*mv);
+    const auto res = game_.tryMakeMove(*r.move);
     if (!res.ok) {
         statusBar()->showMessage(QString("AI move failed: %1").arg(QString::fromStdString(res.message)), 2000);
+        updateUi();
         return;
     }
 
-    const engine::Coord c = *mv;
-    const engine::Player p = game_.board().get(c);
-    const QRectF rect(c.x * cellSize_, c.y * cellSize_, cellSize_, cellSize_);
+    if (r.pondered) statusBar()->showMessage("AI answered with a move prepared on your time.", 2000);
 
-    auto* item = new MarkItem(p, rect);
-    scene_->addItem(item);
-    markItems_[c] = item;
+    if (game_.isGameOver()) {
+        GameOverDialog dlg(game_, this);
+        dlg.exec();
+    } else {
+        ensureAiMoveIfNeeded();
+    }
+}
 
-    lastMoveHighlight_->setRect(rect.adjusted(1, 1, -1, -1));
-    lastMoveHighlight_->show();
+void MainWindow::onGameChanged(const engine::ChangeBatch& b) {
+    if (b.reset) {
+        rebuildScene();
+        return;
+    }
+
+    for (const engine::CellChange& ch : b.cells) {
+        if (ch.set()) stonePlaced(ch.coord, ch.player);
+        else stoneRemoved(ch.coord, ch.previous);
+    }
 
+    showLastMove();
     updateSceneRectForTopology();
     updateUi();
+}
 
-    if (game_.isGameOver()) {
-        GameOverDialog dlg(game_, this);
-        dlg.exec();
+void MainWindow::stonePlaced(engine::Coord c, engine::Player p) {
+    stones_->stonePlaced(c);
+    minimap_->stonePlaced(c, p);
+    stoneBounds_ |= QRect(c.x, c.y, 1, 1);
+    markEvalDirty(c);
+    invalidateHints();
+}
+
+void MainWindow::stoneRemoved(engine::Coord c, engine::Player p) {
+    stones_->stoneRemoved(c);
+    minimap_->stoneRemoved(c, p);
+    markEvalDirty(c);
+    invalidateHints();
+}
+
+void MainWindow::onViewportChanged() {
+    const QRectF v = view_->visibleSceneRect();
+    minimap_->setViewport(QRectF(v.left() / cellSize_, v.top() / cellSize_, v.width() / cellSize_, v.height() / cellSize_));
+
+    // Вид сдвинулся, а оверлей ещё считается: оставшиеся клетки пересортировываются под новый экран.
+    if (evalOverlayOn() && evalPending_.size() > 256) evalTimer_->start();
+}
+
+bool MainWindow::evalOverlayOn() const {
+    return settings_->evalOverlay() > 0;
+}
+
+void MainWindow::onEvalOverlayChanged(int overlay) {
+    if (!evalOverlay_) return;
+    if (overlay <= 0) {
+        eval_->cancel();
+        evalTimer_->stop();
+        evalAll_ = false;
+        evalDirty_.clear();
+        evalPending_.clear();
+        evalOverlay_->clear();
+        evalOverlay_->hide();
+        return;
     }
+
+    evalOverlay_->setMetric(static_cast<EvalOverlayItem::Metric>(overlay - 1));
+    if (!evalOverlay_->isVisible()) {
+        evalOverlay_->show();
+        refreshEvalAll();
+    }
+}
+
+void MainWindow::refreshEvalAll() {
+    if (!evalOverlayOn()) return;
+    evalAll_ = true;
+    evalTimer_->start();
+}
+
+void MainWindow::markEvalDirty(engine::Coord c) {
+    if (!evalOverlayOn()) return; // выключенный оверлей не стоит ничего
+
+    const engine::RuleSet& rules = game_.rules();
+    const bool perPlayerTerms = (rules.moveCostsEnabled && rules.costMode == engine::CostMode::CostFromBudget)
+                             || (rules.weightsEnabled && rules.targetScore > 0);
+    if (perPlayerTerms) {
+        // Оценка зависит от бюджета/счёта ходящего, а он меняется каждым ходом: пересчитываем всё.
+        refreshEvalAll();
+        return;
+    }
+
+    // Клетку меняет камень на одной из её 4 линий: идём по лучам, пока не встретим N пустых клеток
+    // (окна длины N и продолжающие их серии), плюс квадрат фронта, в который клетки входят и из которого выходят.
+    const engine::IBoard& board = game_.board();
+    const int n = std::max(1, rules.N);
+    evalDirty_.insert(c);
+    static constexpr engine::Coord kRays[8] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}, {1, 1}, {-1, -1}, {1, -1}, {-1, 1}};
+    for (const engine::Coord d : kRays) {
+        int empties = 0;
+        for (int k = 1; empties < n; ++k) {
+            const engine::Coord q{c.x + d.x * k, c.y + d.y * k};
+            if (board.isFinite() && !board.inBounds(q)) break;
+            if (board.get(q) == engine::Player::None) ++empties;
+            evalDirty_.insert(q);
+        }
+    }
+    const int r = game_.frontier().radius();
+    for (int dy = -r; dy <= r; ++dy) {
+        for (int dx = -r; dx <= r; ++dx) evalDirty_.insert(engine::Coord{c.x + dx, c.y + dy});
+    }
+    evalTimer_->start();
+}
+
+void MainWindow::sendEvalRequest() {
+    if (!evalOverlayOn()) return;
+
+    const engine::FrontierMaps& frontier = game_.frontier();
+    if (evalAll_) {
+        evalAll_ = false;
+        evalDirty_.clear();
+        evalPending_.clear();
+        evalOverlay_->clear();
+        for (const auto& [c, cell] : frontier.cells()) {
+            (void)cell;
+            evalPending_.insert(c);
+        }
+    } else {
+        for (const engine::Coord& c : evalDirty_) {
+            if (frontier.find(c)) {
+                evalPending_.insert(c);
+            } else {
+                evalPending_.erase(c);
+                evalOverlay_->removeCell(c);
+            }
+        }
+        evalDirty_.clear();
+    }
+
+    if (evalPending_.empty()) {
+        eval_->cancel();
+        return;
+    }
+
+    // Сначала клетки на экране, дальше — по удалённости от его центра.
+    const QRectF v = view_->visibleSceneRect();
+    const QRectF cells(v.left() / cellSize_, v.top() / cellSize_, v.width() / cellSize_, v.height() / cellSize_);
+    const QPointF mid = cells.center();
+    auto key = [&](engine::Coord c) {
+        const bool onScreen = cells.contains(QPointF(c.x + 0.5, c.y + 0.5));
+        const double dist = std::max(std::abs(c.x + 0.5 - mid.x()), std::abs(c.y + 0.5 - mid.y()));
+        return std::make_pair(!onScreen, dist);
+    };
+
+    std::vector<engine::Coord> order(evalPending_.begin(), evalPending_.end());
+    std::sort(order.begin(), order.end(), [&](engine::Coord a, engine::Coord b) { return key(a) < key(b); });
+    eval_->evaluate(game_, std::move(order));
+}
+
+void MainWindow::invalidateHints() {
+    if (settings_->hintsCount() <= 0) return;
+    hints_->clear();
+    eval_->cancelAnalysis();
+    hintsTimer_->start(); // ходы одной пачки (автоигра, undo) — один анализ
+}
+
+void MainWindow::onHintsChanged(int count) {
+    if (!hints_) return;
+    if (count <= 0) {
+        hintsTimer_->stop();
+        eval_->cancelAnalysis();
+        hints_->clear();
+        return;
+    }
+    hintsTimer_->start();
+}
+
+void MainWindow::sendHintsRequest() {
+    const int count = settings_->hintsCount();
+    // Подсказки — для человека: на ходу AI и в AI vs AI не считаем.
+    const bool humanToMove = !aiEnabled_ || (aiPlayer_ != engine::Player::None && game_.currentPlayer() != aiPlayer_);
+    if (count <= 0 || game_.isGameOver() || !humanToMove) {
+        eval_->cancelAnalysis();
+        hints_->clear();
+        return;
+    }
+    eval_->analyse(game_, count, aiRadius_);
+}
+
+void MainWindow::onHintsReady(const EvalHints& h) {
+    if (settings_->hintsCount() <= 0 || h.moveCount != game_.moveCount()) return;
+    hints_->setHints(h.lines);
+
+    QStringList parts;
+    for (std::size_t i = 0; i < h.lines.size(); ++i) {
+        const auto& line = h.lines[i];
+        QString part = QString("%1) (%2,%3)").arg(i + 1).arg(line.move.x).arg(line.move.y);
+        if (line.pv.size() > 1) part += QString(" -> (%1,%2)").arg(line.pv[1].x).arg(line.pv[1].y);
+        parts << part;
+    }
+    if (!parts.isEmpty()) statusBar()->showMessage("Hints: " + parts.join("  "), 8000);
+}
+
+void MainWindow::onEvalBatch(const EvalBatch& b) {
+    if (!evalOverlayOn()) return;
+
+    // Пачка могла прийти после хода, но до нового запроса: клетки, ушедшие с фронта, не показываем.
+    std::vector<EvalCell> fresh;
+    fresh.reserve(b.cells.size());
+    for (const EvalCell& cell : b.cells) {
+        evalPending_.erase(cell.c);
+        if (game_.frontier().find(cell.c)) fresh.push_back(cell);
+    }
+    evalOverlay_->setScores(fresh);
+}
+
+void MainWindow::onMinimapJump(const QPointF& cell) {
+    view_->centerOn(cell * cellSize_);
 }
 
 void MainWindow::updateSceneRectForTopology() {
+    const QRect cells = boardCells();
     const QRectF r = boardSceneRect();
+    if (r == scene_->sceneRect()) return;
+
     scene_->setSceneRect(r);
     if (grid_) grid_->setRect(r);
+    if (stones_) stones_->setRect(r);
+    if (evalOverlay_) evalOverlay_->setRect(r);
+    if (hints_) hints_->setRect(r);
+    minimap_->setArea(cells);
 }
 
-QRectF MainWindow::boardSceneRect() const {
+QRect MainWindow::boardCells() const {
     const auto& r = game_.rules();
 
     if (r.topology == engine::BoardTopology::Finite) {
-        return QRectF(0, 0, r.width * cellSize_, r.height * cellSize_);
+        return QRect(0, 0, r.width, r.height);
     }
 
-    const auto occ = game_.board().occupied();
-
-    int minX = 0, maxX = 0, minY = 0, maxY = 0;
-
-    if (occ.empty()) {
-        minX = -20; maxX = 20;
-        minY = -20; maxY = 20;
-    } else {
-        minX = occ[0].first.x; maxX = occ[0].first.x;
-        minY = occ[0].first.y; maxY = occ[0].first.y;
-        for (const auto& [c, p] : occ) {
-            (void)p;
-            minX = std::min(minX, c.x);
-            maxX = std::max(maxX, c.x);
-            minY = std::min(minY, c.y);
-            maxY = std::max(maxY, c.y);
-        }
-        constexpr int margin = 20;
-        minX -= margin; maxX += margin;
-        minY -= margin; maxY += margin;
-    }
+    // Бесконечная доска: рамка камней с полями, без обхода доски на каждом ходу.
+    constexpr int margin = 20;
+    if (stoneBounds_.isEmpty()) return QRect(QPoint(-margin, -margin), QPoint(margin, margin));
+    return stoneBounds_.adjusted(-margin, -margin, margin, margin);
+}
 
-    const qreal left = static_cast<qreal>(minX) * cellSize_;
-    const qreal top = static_cast<qreal>(minY) * cellSize_;
-    const qreal right = static_cast<qreal>(maxX + 1) * cellSize_;
-    const qreal bottom = static_cast<qreal>(maxY + 1) * cellSize_;
-    return QRectF(QPointF(left, top), QPointF(right, bottom));
-}
\ No newline at end of file
+QRectF MainWindow::boardSceneRect() const {
+    const QRect c = boardCells();
+    return QRectF(static_cast<qreal>(c.x()) * cellSize_, static_cast<qreal>(c.y()) * cellSize_,
+                  static_cast<qreal>(c.width()) * cellSize_, static_cast<qreal>(c.height()) * cellSize_);
+}
@@ -4,18 +4,27 @@
 
 #include <QMainWindow>
 #include <QGraphicsScene>
+#include <QRect>
 
-#include <unordered_map>
+#include <memory>
+#include <unordered_set>
 
 #include <engine/AI.h>
 #include <engine/GameState.h>
 
+#include "AiWorker.h"
 #include "AppConfig.h"
+#include "EvalWorker.h"
 
 class BoardView;
+class EvalOverlayItem;
 class GridItem;
+class HintLayerItem;
+class MinimapWidget;
+class StoneLayerItem;
 class SettingsPanel;
 class QGraphicsRectItem;
+class QTimer;
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
@@ -29,6 +38,21 @@ private slots:
     void onRedoRequested();
     void onNextTurnRequested();
     void onResetViewRequested();
+    void onCancelAiRequested();
+    void onPonderToggled(bool on);
+    void onAiProgress(const AiProgress& p);
+    void onAiMoveReady(const AiResult& r);
+    void onViewportChanged();
+    void onAutoplayToggled(bool on);
+    void onAutoplaySpeedChanged(int movesPerSecond);
+    void onAutoplayFrame();
+    void onEvalOverlayChanged(int overlay);
+    void onEvalBatch(const EvalBatch& b);
+    void sendEvalRequest();
+    void onHintsChanged(int count);
+    void onHintsReady(const EvalHints& h);
+    void sendHintsRequest();
+    void onMinimapJump(const QPointF& cell);
 
 private:
     void startNewGame(const engine::RuleSet& rules);
@@ -37,16 +61,34 @@ private:
     void updateUi();
     bool isAiVsAiModeActive() const;
     void ensureAiMoveIfNeeded();
-    void performAiMove(engine::Player aiPlayer);
+    void requestAiMove(engine::Player aiPlayer);
+    void cancelAiSearch();
+    void ponderIfHumanToMove();
+    void startAutoplay();
+    void stopAutoplay();
+    void showLastMove();
+    bool evalOverlayOn() const;
+    void markEvalDirty(engine::Coord c);
+    void refreshEvalAll();
+    void invalidateHints();
+
+    // The game's change feed drives the views: a reset rebuilds the scene, otherwise only the changed cells are
+    // applied, then the highlight, scene rect and panel once per batch. Move handlers only talk to game_.
+    void onGameChanged(const engine::ChangeBatch& b);
+    void stonePlaced(engine::Coord c, engine::Player p);
+    void stoneRemoved(engine::Coord c, engine::Player p);
 
     void updateSceneRectForTopology();
+    QRect boardCells() const;
     QRectF boardSceneRect() const;
 
 private:
     AppConfig cfg_;
 
     engine::GameState game_;
-    engine::SimpleAI ai_;
+    AiRunner* ai_ = nullptr; // searches run on its thread, the GUI thread only applies their moves
+    std::shared_ptr<const engine::Tablebase> tablebase_;
+    std::shared_ptr<const engine::OpeningBook> openingBook_;
 
     bool aiEnabled_ = false;
     engine::Player aiPlayer_ = engine::Player::O;
@@ -57,11 +99,31 @@ private:
     SettingsPanel* settings_ = nullptr;
 
     GridItem* grid_ = nullptr;
+    StoneLayerItem* stones_ = nullptr;
     QGraphicsRectItem* lastMoveHighlight_ = nullptr;
+    MinimapWidget* minimap_ = nullptr;
 
-    int cellSize_ = 40;
+    // AI vs AI autoplay: the AI thread plays, the GUI applies the moves once per display frame.
+    std::shared_ptr<AutoplayFeed> autoplay_;
+    QTimer* autoplayTimer_ = nullptr;
+
+    // Evaluation overlay: cells whose scores a move may have changed are rescored on the eval thread, the ones
+    // on screen first. Nothing is tracked while it is off.
+    EvalRunner* eval_ = nullptr;
+    EvalOverlayItem* evalOverlay_ = nullptr;
+    QTimer* evalTimer_ = nullptr; // coalesces the moves of one event-loop turn into one request
+    bool evalAll_ = false;
+    std::unordered_set<engine::Coord, engine::CoordHash> evalDirty_;   // not requested yet
+    std::unordered_set<engine::Coord, engine::CoordHash> evalPending_; // requested, not scored yet
+
+    // Numbered hints for the human to move: one multi-PV analysis per position, on the eval thread.
+    HintLayerItem* hints_ = nullptr;
+    QTimer* hintsTimer_ = nullptr;
 
-    std::unordered_map<engine::Coord, QGraphicsItem*, engine::CoordHash> markItems_;
+    // Bounding box of the stones in cells, grown per move; undo does not shrink it (the view keeps its extent).
+    QRect stoneBounds_;
+
+    int cellSize_ = 40;
 };
 
 #endif
\ No newline at end of file
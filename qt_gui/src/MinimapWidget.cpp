@@ -0,0 +1,188 @@
+#include "MinimapWidget.h"
+
+#include <QColor>
+#include <QMouseEvent>
+#include <QPainter>
+
+#include <algorithm>
+
+namespace {
+
+// Дальше масштаб не растёт: начало картинки должно оставаться в int, а шире 2^28 клеток партия не бывает.
+constexpr int kMaxScale = 1 << 20;
+
+QColor mixColor(quint32 x, quint32 o) {
+    // Цвет пикселя — доля крестиков (красный) против ноликов (синий) в его клетках.
+    const qreal share = static_cast<qreal>(x) / (x + o);
+    return QColor(static_cast<int>(30 + (220 - 30) * share),
+                  static_cast<int>(60 + (30 - 60) * share),
+                  static_cast<int>(220 + (30 - 220) * share));
+}
+
+}
+
+MinimapWidget::MinimapWidget(QWidget* parent)
+    : QWidget(parent) {
+    setMinimumSize(120, 120);
+    setCursor(Qt::PointingHandCursor);
+    reset();
+}
+
+void MinimapWidget::reset() {
+    image_ = QImage(kSize, kSize, QImage::Format_ARGB32_Premultiplied);
+    image_.fill(Qt::transparent);
+    counts_.assign(static_cast<std::size_t>(kSize) * kSize, Pixel{});
+    origin_ = engine::Coord{-kSize / 2, -kSize / 2};
+    scale_ = 1;
+}
+
+void MinimapWidget::setBoard(const engine::IBoard& board) {
+    reset();
+    for (const auto& [c, p] : board.occupied()) addStone(c, p, +1);
+    update();
+}
+
+void MinimapWidget::stonePlaced(engine::Coord c, engine::Player p) {
+    addStone(c, p, +1);
+    update();
+}
+
+void MinimapWidget::stoneRemoved(engine::Coord c, engine::Player p) {
+    addStone(c, p, -1);
+    update();
+}
+
+void MinimapWidget::setArea(const QRect& cells) {
+    area_ = cells;
+    if (!area_.isEmpty()) cover(area_);
+    update();
+}
+
+void MinimapWidget::setViewport(const QRectF& cells) {
+    viewport_ = cells;
+    update();
+}
+
+void MinimapWidget::cover(const QRect& cells) {
+    auto inside = [this](int x, int y) {
+        const long long span = static_cast<long long>(kSize) * scale_;
+        return x >= origin_.x && x - static_cast<long long>(origin_.x) < span
+            && y >= origin_.y && y - static_cast<long long>(origin_.y) < span;
+    };
+    while (scale_ < kMaxScale && !inside(cells.left(), cells.top())) grow(engine::Coord{cells.left(), cells.top()});
+    while (scale_ < kMaxScale && !inside(cells.right(), cells.bottom())) grow(engine::Coord{cells.right(), cells.bottom()});
+}
+
+void MinimapWidget::grow(engine::Coord towards) {
+    // Вдвое крупнее: старая картинка ужимается в четверть новой, в сторону нужной клетки. O(kSize²), не O(камней).
+    const long long span = static_cast<long long>(kSize) * scale_;
+    const bool left = towards.x < origin_.x + span / 2;
+    const bool up = towards.y < origin_.y + span / 2;
+    const int offX = left ? kSize : 0;
+    const int offY = up ? kSize : 0;
+
+    std::vector<Pixel> next(counts_.size());
+    for (int py = 0; py < kSize; ++py) {
+        for (int px = 0; px < kSize; ++px) {
+            const Pixel& from = counts_[static_cast<std::size_t>(py) * kSize + px];
+            if (from.x + from.o == 0) continue;
+            Pixel& to = next[static_cast<std::size_t>((py + offY) / 2) * kSize + (px + offX) / 2];
+            to.x += from.x;
+            to.o += from.o;
+        }
+    }
+    counts_ = std::move(next);
+
+    if (left) origin_.x = static_cast<int>(origin_.x - span);
+    if (up) origin_.y = static_cast<int>(origin_.y - span);
+    scale_ *= 2;
+
+    image_.fill(Qt::transparent);
+    for (int py = 0; py < kSize; ++py) {
+        for (int px = 0; px < kSize; ++px) repaintPixel(px, py);
+    }
+}
+
+void MinimapWidget::addStone(engine::Coord c, engine::Player p, int delta) {
+    if (p == engine::Player::None) return;
+    if (delta > 0) cover(QRect(c.x, c.y, 1, 1));
+
+    const long long dx = static_cast<long long>(c.x) - origin_.x;
+    const long long dy = static_cast<long long>(c.y) - origin_.y;
+    const long long span = static_cast<long long>(kSize) * scale_;
+    if (dx < 0 || dy < 0 || dx >= span || dy >= span) return;
+
+    const int px = static_cast<int>(dx / scale_);
+    const int py = static_cast<int>(dy / scale_);
+    Pixel& pixel = counts_[static_cast<std::size_t>(py) * kSize + px];
+    quint32& n = (p == engine::Player::X) ? pixel.x : pixel.o;
+    if (delta > 0) ++n;
+    else if (n > 0) --n;
+    repaintPixel(px, py);
+}
+
+void MinimapWidget::repaintPixel(int px, int py) {
+    const Pixel& pixel = counts_[static_cast<std::size_t>(py) * kSize + px];
+    image_.setPixel(px, py, pixel.x + pixel.o == 0 ? qRgba(0, 0, 0, 0) : mixColor(pixel.x, pixel.o).rgba());
+}
+
+QRectF MinimapWidget::target() const {
+    // Область вписывается в виджет с сохранением пропорций.
+    const QRectF box = QRectF(rect()).adjusted(4, 4, -4, -4);
+    if (area_.isEmpty() || box.isEmpty()) return QRectF();
+    const qreal k = std::min(box.width() / area_.width(), box.height() / area_.height());
+    QRectF t(0, 0, area_.width() * k, area_.height() * k);
+    t.moveCenter(box.center());
+    return t;
+}
+
+void MinimapWidget::paintEvent(QPaintEvent*) {
+    QPainter painter(this);
+    painter.fillRect(rect(), palette().window());
+
+    const QRectF t = target();
+    if (t.isEmpty()) return;
+
+    painter.fillRect(t, Qt::white);
+    const QRectF source((area_.x() - static_cast<qreal>(origin_.x)) / scale_,
+                        (area_.y() - static_cast<qreal>(origin_.y)) / scale_,
+                        static_cast<qreal>(area_.width()) / scale_,
+                        static_cast<qreal>(area_.height()) / scale_);
+    painter.drawImage(t, image_, source);
+
+    painter.setPen(QPen(Qt::gray, 0));
+    painter.setBrush(Qt::NoBrush);
+    painter.drawRect(t);
+
+    if (!viewport_.isEmpty()) {
+        const qreal k = t.width() / area_.width();
+        const QRectF v(t.left() + (viewport_.left() - area_.x()) * k,
+                       t.top() + (viewport_.top() - area_.y()) * k,
+                       viewport_.width() * k,
+                       viewport_.height() * k);
+        painter.setClipRect(t);
+        painter.setPen(QPen(QColor(255, 170, 0), 2.0));
+        painter.drawRect(v);
+    }
+}
+
+void MinimapWidget::mousePressEvent(QMouseEvent* event) {
+    if (event->button() != Qt::LeftButton) {
+        QWidget::mousePressEvent(event);
+        return;
+    }
+    mouseMoveEvent(event);
+}
+
+void MinimapWidget::mouseMoveEvent(QMouseEvent* event) {
+    const QRectF t = target();
+    if (!(event->buttons() & Qt::LeftButton) || t.isEmpty()) {
+        QWidget::mouseMoveEvent(event);
+        return;
+    }
+
+    const QPointF pos = event->position();
+    const qreal k = t.width() / area_.width();
+    emit jumpRequested(QPointF(area_.x() + (pos.x() - t.left()) / k, area_.y() + (pos.y() - t.top()) / k));
+    event->accept();
+}
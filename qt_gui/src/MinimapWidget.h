@@ -0,0 +1,65 @@
+#ifndef TIKTAKTOE_MINIMAPWIDGET_H
+#define TIKTAKTOE_MINIMAPWIDGET_H
+#pragma once
+
+#include <QImage>
+#include <QRect>
+#include <QRectF>
+#include <QWidget>
+
+#include <vector>
+
+#include <engine/Board.h>
+
+// Overview of the board area: stones as a kSize x kSize image where a pixel covers scale() x scale() cells, the
+// visible part of the board view as a frame, and a click or drag centres the view there. A stone updates one pixel;
+// when the area outgrows the image the scale doubles and the image is halved in place, never rebuilt from the board.
+class MinimapWidget : public QWidget {
+    Q_OBJECT
+public:
+    static constexpr int kSize = 256;
+
+    explicit MinimapWidget(QWidget* parent = nullptr);
+
+    QSize sizeHint() const override { return QSize(200, 200); }
+
+    void setBoard(const engine::IBoard& board); // full rebuild: new game only
+    void stonePlaced(engine::Coord c, engine::Player p);
+    void stoneRemoved(engine::Coord c, engine::Player p);
+
+    void setArea(const QRect& cells);      // shown part of the board, in cells
+    void setViewport(const QRectF& cells); // visible part of the board view, in cells
+
+    int scale() const noexcept { return scale_; }
+
+signals:
+    void jumpRequested(const QPointF& cell);
+
+protected:
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+
+private:
+    struct Pixel {
+        quint32 x = 0;
+        quint32 o = 0;
+    };
+
+    void reset();
+    void cover(const QRect& cells);
+    void grow(engine::Coord towards);
+    void addStone(engine::Coord c, engine::Player p, int delta);
+    void repaintPixel(int px, int py);
+    QRectF target() const;
+
+    QImage image_;
+    std::vector<Pixel> counts_; // kSize * kSize, row-major
+    engine::Coord origin_{};    // cell at the top-left of the image
+    int scale_ = 1;             // cells per pixel side
+
+    QRect area_;
+    QRectF viewport_;
+};
+
+#endif
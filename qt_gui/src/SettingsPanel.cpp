@@ -6,14 +6,27 @@
 #include <QGroupBox>
 #include <QHBoxLayout>
 #include <QLabel>
+#include <QProgressBar>
 #include <QPushButton>
+#include <QSignalBlocker>
+#include <QSlider>
 #include <QSpinBox>
 #include <QVBoxLayout>
 
+#include <algorithm>
+
+namespace {
+
+// Последнее деление ползунка автоигры — без ограничения скорости.
+constexpr int kAutoplayMaxRate = 200;
+
+}
+
 SettingsPanel::SettingsPanel(QWidget* parent)
     : QWidget(parent) {
     buildUi();
     updateUiEnabledStates();
+    setAiThinking(false);
 }
 
 void SettingsPanel::buildUi() {
@@ -116,6 +129,40 @@ void SettingsPanel::buildUi() {
     aiRadiusSpin_->setValue(2);
     aiForm->addRow("Candidate radius:", aiRadiusSpin_);
 
+    aiPonderCheck_ = new QCheckBox("Think on opponent's time", aiGroup);
+    aiPonderCheck_->setChecked(true);
+    aiPonderCheck_->setToolTip("While you think, the AI prepares answers to your likely moves.");
+    aiForm->addRow("", aiPonderCheck_);
+
+    evalOverlayCombo_ = new QComboBox(aiGroup);
+    evalOverlayCombo_->addItem("Off");
+    evalOverlayCombo_->addItem("Move score");
+    evalOverlayCombo_->addItem("Own potential");
+    evalOverlayCombo_->addItem("Opponent potential");
+    evalOverlayCombo_->setToolTip("Colour the cells near the stones by what the AI thinks of them for the side to move.");
+    aiForm->addRow("Evaluation:", evalOverlayCombo_);
+
+    hintsSpin_ = new QSpinBox(aiGroup);
+    hintsSpin_->setRange(0, 9);
+    hintsSpin_->setValue(0);
+    hintsSpin_->setSpecialValueText("Off");
+    hintsSpin_->setToolTip("Number the AI's best moves for you on the board (one search for all of them).");
+    aiForm->addRow("Hints:", hintsSpin_);
+
+    aiProgressBar_ = new QProgressBar(aiGroup);
+    aiProgressBar_->setTextVisible(false);
+    aiProgressBar_->setMaximumHeight(12);
+    cancelAiBtn_ = new QPushButton("Cancel", aiGroup);
+    cancelAiBtn_->setToolTip("Stop the AI search now; it plays the best move found so far.");
+    auto* aiProgressRow = new QHBoxLayout();
+    aiProgressRow->addWidget(aiProgressBar_, 1);
+    aiProgressRow->addWidget(cancelAiBtn_);
+    aiForm->addRow("Thinking:", aiProgressRow);
+
+    aiProgressLabel_ = new QLabel(aiGroup);
+    aiProgressLabel_->setWordWrap(true);
+    aiForm->addRow("", aiProgressLabel_);
+
     root->addWidget(aiGroup);
 
     auto* btnRow = new QHBoxLayout();
@@ -132,6 +179,25 @@ void SettingsPanel::buildUi() {
     nextTurnBtn_->setVisible(false);
     root->addLayout(btnRow);
 
+    autoplayRow_ = new QWidget(this);
+    auto* autoplayLayout = new QHBoxLayout(autoplayRow_);
+    autoplayLayout->setContentsMargins(0, 0, 0, 0);
+    autoplayBtn_ = new QPushButton("Autoplay", autoplayRow_);
+    autoplayBtn_->setCheckable(true);
+    autoplayBtn_->setToolTip("Let both AIs play on their own until the game ends.");
+    autoplaySlider_ = new QSlider(Qt::Horizontal, autoplayRow_);
+    autoplaySlider_->setRange(1, kAutoplayMaxRate + 1);
+    autoplaySlider_->setValue(10);
+    autoplaySlider_->setToolTip("Moves per second; the rightmost step plays as fast as the AI searches.");
+    autoplayLabel_ = new QLabel(autoplayRow_);
+    autoplayLabel_->setMinimumWidth(70);
+    autoplayLayout->addWidget(autoplayBtn_);
+    autoplayLayout->addWidget(autoplaySlider_, 1);
+    autoplayLayout->addWidget(autoplayLabel_);
+    autoplayRow_->setVisible(false);
+    root->addWidget(autoplayRow_);
+    onAutoplaySliderMoved(autoplaySlider_->value());
+
     statusLabel_ = new QLabel(this);
     statusLabel_->setText("Ready");
     statusLabel_->setWordWrap(true);
@@ -156,6 +222,12 @@ void SettingsPanel::buildUi() {
     connect(costModeCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsPanel::onCostModeChanged);
     connect(aiCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsPanel::onAiModeChanged);
     connect(nextTurnBtn_, &QPushButton::clicked, this, &SettingsPanel::nextTurnRequested);
+    connect(autoplayBtn_, &QPushButton::toggled, this, &SettingsPanel::autoplayToggled);
+    connect(autoplaySlider_, &QSlider::valueChanged, this, &SettingsPanel::onAutoplaySliderMoved);
+    connect(cancelAiBtn_, &QPushButton::clicked, this, &SettingsPanel::cancelAiRequested);
+    connect(aiPonderCheck_, &QCheckBox::toggled, this, &SettingsPanel::ponderToggled);
+    connect(evalOverlayCombo_, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &SettingsPanel::evalOverlayChanged);
+    connect(hintsSpin_, QOverload<int>::of(&QSpinBox::valueChanged), this, &SettingsPanel::hintsChanged);
     connect(newGameBtn_, &QPushButton::clicked, this, &SettingsPanel::newGameRequested);
     connect(undoBtn_, &QPushButton::clicked, this, &SettingsPanel::undoRequested);
     connect(redoBtn_, &QPushButton::clicked, this, &SettingsPanel::redoRequested);
@@ -172,6 +244,41 @@ void SettingsPanel::setNextTurnVisible(bool visible) {
 void SettingsPanel::setNextTurnEnabled(bool enabled) {
     if (nextTurnBtn_) nextTurnBtn_->setEnabled(enabled);
 }
+
+void SettingsPanel::setAutoplayVisible(bool visible) {
+    autoplayRow_->setVisible(visible);
+}
+
+void SettingsPanel::setAutoplayRunning(bool running) {
+    const QSignalBlocker block(autoplayBtn_);
+    autoplayBtn_->setChecked(running);
+    autoplayBtn_->setText(running ? "Stop" : "Autoplay");
+}
+
+int SettingsPanel::autoplaySpeed() const {
+    const int v = autoplaySlider_->value();
+    return v > kAutoplayMaxRate ? 0 : v;
+}
+
+void SettingsPanel::onAutoplaySliderMoved(int) {
+    const int rate = autoplaySpeed();
+    autoplayLabel_->setText(rate == 0 ? QString("unlimited") : QString("%1 moves/s").arg(rate));
+    emit autoplaySpeedChanged(rate);
+}
+void SettingsPanel::setAiThinking(bool thinking) {
+    cancelAiBtn_->setEnabled(thinking);
+    aiProgressBar_->setRange(0, 1);
+    aiProgressBar_->setValue(0);
+    if (!thinking) aiProgressLabel_->clear();
+}
+
+void SettingsPanel::setAiProgress(const QString& text, int done, int total) {
+    // Диапазон 0..0 — «бегущая» полоса, пока число шагов неизвестно.
+    aiProgressBar_->setRange(0, std::max(0, total));
+    aiProgressBar_->setValue(std::min(done, total));
+    aiProgressLabel_->setText(text);
+}
+
 void SettingsPanel::onPresetChanged(int idx) {
     if (idx == 0) { widthSpin_->setValue(10); heightSpin_->setValue(10); }
     if (idx == 1) { widthSpin_->setValue(20); heightSpin_->setValue(20); }
@@ -211,6 +318,7 @@ void SettingsPanel::updateUiEnabledStates() {
 
     const bool aiOn = (aiCombo_->currentIndex() != 0);
     aiRadiusSpin_->setEnabled(aiOn);
+    aiPonderCheck_->setEnabled(aiOn && aiCombo_->currentIndex() != 3); // в AI vs AI думать на чужом времени некому
 
     const bool atleast = (lineModeCombo_->currentIndex() == 0);
     countSubsegmentsCheck_->setEnabled(atleast);
@@ -340,6 +448,23 @@ int SettingsPanel::aiCandidateRadius() const {
     return aiRadiusSpin_->value();
 }
 
+bool SettingsPanel::aiPonder() const {
+    return aiPonderCheck_->isChecked();
+}
+
+void SettingsPanel::setAiPonder(bool on) {
+    QSignalBlocker b(aiPonderCheck_);
+    aiPonderCheck_->setChecked(on);
+}
+
+int SettingsPanel::evalOverlay() const {
+    return evalOverlayCombo_->currentIndex();
+}
+
+int SettingsPanel::hintsCount() const {
+    return hintsSpin_->value();
+}
+
 void SettingsPanel::setAiSettings(bool enabled, engine::Player aiPlayer, int radius) {
     QSignalBlocker b1(aiCombo_);
     if (!enabled) {
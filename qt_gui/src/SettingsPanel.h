@@ -10,7 +10,9 @@
 class QCheckBox;
 class QComboBox;
 class QLabel;
+class QProgressBar;
 class QPushButton;
+class QSlider;
 class QSpinBox;
 
 class SettingsPanel : public QWidget {
@@ -24,10 +26,23 @@ public:
     bool aiEnabled() const;
     engine::Player aiPlayer() const;
     int aiCandidateRadius() const;
+    bool aiPonder() const;
+    void setAiPonder(bool on);
+    int evalOverlay() const; // 0 = off, then EvalOverlayItem::Metric + 1
+    int hintsCount() const;  // 0 = off
 
     void setAiSettings(bool enabled, engine::Player aiPlayer, int radius);
     void setNextTurnVisible(bool visible);
     void setNextTurnEnabled(bool enabled);
+
+    // AI vs AI autoplay row: a start/stop button and a moves-per-second slider whose last step is "unlimited".
+    void setAutoplayVisible(bool visible);
+    void setAutoplayRunning(bool running); // does not emit autoplayToggled
+    int autoplaySpeed() const;             // moves per second, 0 = unlimited
+
+    // Progress row of the AI group: shown with an enabled Cancel button while a search runs.
+    void setAiThinking(bool thinking);
+    void setAiProgress(const QString& text, int done, int total); // total 0 = busy indicator
     void updateFromGameState(const engine::GameState& state);
     signals:
         void newGameRequested();
@@ -35,6 +50,12 @@ public:
     void redoRequested();
     void resetViewRequested();
     void nextTurnRequested();
+    void cancelAiRequested();
+    void ponderToggled(bool on);
+    void autoplayToggled(bool on);
+    void autoplaySpeedChanged(int movesPerSecond);
+    void evalOverlayChanged(int overlay);
+    void hintsChanged(int count);
 
 private slots:
     void onTopologyChanged(int);
@@ -42,6 +63,7 @@ private slots:
     void onRuleTogglesChanged();
     void onCostModeChanged(int);
     void onAiModeChanged(int);
+    void onAutoplaySliderMoved(int value);
 
 private:
     void buildUi();
@@ -68,12 +90,22 @@ private:
 
     QComboBox* aiCombo_ = nullptr;
     QSpinBox* aiRadiusSpin_ = nullptr;
+    QCheckBox* aiPonderCheck_ = nullptr;
+    QComboBox* evalOverlayCombo_ = nullptr;
+    QSpinBox* hintsSpin_ = nullptr;
+    QProgressBar* aiProgressBar_ = nullptr;
+    QLabel* aiProgressLabel_ = nullptr;
+    QPushButton* cancelAiBtn_ = nullptr;
 
     QPushButton* newGameBtn_ = nullptr;
     QPushButton* undoBtn_ = nullptr;
     QPushButton* redoBtn_ = nullptr;
     QPushButton* resetViewBtn_ = nullptr;
     QPushButton* nextTurnBtn_ = nullptr;
+    QWidget* autoplayRow_ = nullptr;
+    QPushButton* autoplayBtn_ = nullptr;
+    QSlider* autoplaySlider_ = nullptr;
+    QLabel* autoplayLabel_ = nullptr;
     QLabel* statusLabel_ = nullptr;
     QLabel* statsLabel_ = nullptr;
 };
@@ -0,0 +1,214 @@
+#include "StoneLayerItem.h"
+
+#include <QColor>
+#include <QPainter>
+#include <QPaintDevice>
+#include <QStyleOptionGraphicsItem>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// Кэш плиток: не больше ~16M пикселей (64 МБ), лишние вытесняются по LRU.
+constexpr int kCachePixels = 16 * 1024 * 1024;
+
+// Крупнее этого плитка рисуется напрямую: при сильном увеличении на экране их единицы.
+constexpr qreal kMaxTilePixels = 1024.0;
+
+quint64 tileKey(engine::Coord t) {
+    return (static_cast<quint64>(static_cast<quint32>(t.x)) << 32) | static_cast<quint32>(t.y);
+}
+
+QColor stoneColor(engine::Player p) {
+    // X — красный, O — синий
+    if (p == engine::Player::X) return QColor(220, 30, 30);
+    if (p == engine::Player::O) return QColor(30, 60, 220);
+    return QColor(Qt::black);
+}
+
+}
+
+StoneLayerItem::StoneLayerItem(const QRectF& rect, int cellSizePx)
+    : rect_(rect), cellSize_(std::max(2, cellSizePx)), cache_(kCachePixels) {
+    setZValue(2);
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption); // без флага exposedRect — весь boundingRect
+}
+
+void StoneLayerItem::setRect(const QRectF& r) {
+    prepareGeometryChange();
+    rect_ = r;
+}
+
+void StoneLayerItem::setBoard(const engine::IBoard* board) {
+    board_ = board;
+    tiles_.clear();
+    cache_.clear();
+    if (board_) {
+        for (const auto& [c, p] : board_->occupied()) {
+            Tile& tile = tiles_[Tiles::tileOf(c)];
+            if (p == engine::Player::X) ++tile.x;
+            else ++tile.o;
+        }
+    }
+    update();
+}
+
+void StoneLayerItem::stonePlaced(engine::Coord c) {
+    refreshTile(Tiles::tileOf(c));
+}
+
+void StoneLayerItem::stoneRemoved(engine::Coord c) {
+    refreshTile(Tiles::tileOf(c));
+}
+
+void StoneLayerItem::refreshTile(engine::Coord t) {
+    // Плитка пересчитывается с доски целиком: kTileCells² клеток, O(1) на ход при любой длине партии.
+    cache_.remove(tileKey(t));
+    update(tileRect(t));
+    if (!board_) return;
+
+    Tile& tile = tiles_[t];
+    tile.x = tile.o = 0;
+    for (int y = t.y * kTileCells; y < (t.y + 1) * kTileCells; ++y) {
+        for (int x = t.x * kTileCells; x < (t.x + 1) * kTileCells; ++x) {
+            const engine::Coord c{x, y};
+            if (board_->isFinite() && !board_->inBounds(c)) continue;
+            const engine::Player p = board_->get(c);
+            if (p == engine::Player::X) ++tile.x;
+            if (p == engine::Player::O) ++tile.o;
+        }
+    }
+
+    if (tile.x + tile.o == 0) {
+        tiles_.erase(t);
+        return;
+    }
+    if (!tile.raster.isNull()) fillRaster(t, tile);
+}
+
+void StoneLayerItem::fillRaster(engine::Coord t, Tile& tile) const {
+    if (tile.raster.isNull()) tile.raster = QImage(kTileCells, kTileCells, QImage::Format_ARGB32_Premultiplied);
+    tile.raster.fill(Qt::transparent);
+    for (int dy = 0; dy < kTileCells; ++dy) {
+        for (int dx = 0; dx < kTileCells; ++dx) {
+            const engine::Coord c{t.x * kTileCells + dx, t.y * kTileCells + dy};
+            if (board_->isFinite() && !board_->inBounds(c)) continue;
+            const engine::Player p = board_->get(c);
+            if (p != engine::Player::None) tile.raster.setPixel(dx, dy, stoneColor(p).rgba());
+        }
+    }
+}
+
+QRectF StoneLayerItem::tileRect(engine::Coord t) const {
+    return Tiles::tileRect(t, cellSize_);
+}
+
+void StoneLayerItem::paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget*) {
+    if (!board_ || tiles_.empty()) return;
+
+    const QRectF exposed = option->exposedRect.intersected(rect_);
+    if (!exposed.isValid() || exposed.isEmpty()) return;
+
+    // Пикселей устройства на единицу сцены: по нему плитка рендерится без размытия.
+    const qreal lod = QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    const qreal scale = lod * (painter->device() ? painter->device()->devicePixelRatioF() : 1.0);
+
+    // Уровень детализации по экранному размеру клетки: фигуры, растр клетка=пиксель или плотность плиток.
+    const qreal cellPixels = lod * cellSize_;
+    const bool shapes = cellPixels >= kShapeMinPixels;
+    const bool raster = !shapes && cellPixels >= kRasterMinPixels;
+    if (!shapes) painter->setRenderHint(QPainter::SmoothPixmapTransform, false);
+
+    tiles_.forEachVisible(exposed, cellSize_, [&](engine::Coord t, Tile& tile) {
+        if (shapes) {
+            paintTile(painter, t, exposed, scale);
+        } else if (raster) {
+            if (tile.raster.isNull()) fillRaster(t, tile);
+            painter->drawImage(tileRect(t), tile.raster);
+        } else {
+            paintDensity(painter, t, tile);
+        }
+    });
+}
+
+void StoneLayerItem::paintDensity(QPainter* painter, engine::Coord t, const Tile& tile) const {
+    // Цвет — доля крестиков против ноликов, непрозрачность — заполненность; плитка на четверть полна — уже сплошная.
+    const int n = tile.x + tile.o;
+    const qreal share = static_cast<qreal>(tile.x) / n;
+    const qreal fill = std::min<qreal>(1.0, 4.0 * n / (kTileCells * kTileCells));
+    const QColor x = stoneColor(engine::Player::X);
+    const QColor o = stoneColor(engine::Player::O);
+    QColor c(static_cast<int>(o.red() + (x.red() - o.red()) * share),
+             static_cast<int>(o.green() + (x.green() - o.green()) * share),
+             static_cast<int>(o.blue() + (x.blue() - o.blue()) * share));
+    c.setAlphaF(0.25 + 0.75 * fill);
+    painter->fillRect(tileRect(t), c);
+}
+
+void StoneLayerItem::paintTile(QPainter* painter, engine::Coord t, const QRectF& exposed, qreal scale) {
+    const QRectF r = tileRect(t);
+    const qreal px = std::max<qreal>(1.0, std::ceil(r.width() * scale));
+    if (px > kMaxTilePixels) {
+        paintCells(painter, t, exposed);
+        return;
+    }
+
+    const quint64 key = tileKey(t);
+    if (const CachedTile* tile = cache_.object(key); tile && qFuzzyCompare(tile->scale, scale)) {
+        painter->drawPixmap(r.topLeft(), tile->pixmap);
+        return;
+    }
+
+    auto* fresh = new CachedTile;
+    fresh->scale = scale;
+    fresh->pixmap = QPixmap(static_cast<int>(px), static_cast<int>(px));
+    fresh->pixmap.fill(Qt::transparent);
+    {
+        QPainter p(&fresh->pixmap);
+        p.scale(px / r.width(), px / r.height());
+        p.translate(-r.topLeft());
+        paintCells(&p, t, r);
+    }
+    fresh->pixmap.setDevicePixelRatio(px / r.width());
+
+    painter->drawPixmap(r.topLeft(), fresh->pixmap);
+    cache_.insert(key, fresh, static_cast<int>(px * px)); // кэш владеет плиткой и может вытеснить её сразу
+}
+
+void StoneLayerItem::paintCells(QPainter* painter, engine::Coord t, const QRectF& exposed) const {
+    // Только клетки плитки, задетые областью перерисовки; камни читаются прямо с доски движка.
+    const int x0 = std::max(t.x * kTileCells, static_cast<int>(std::floor(exposed.left() / cellSize_)));
+    const int x1 = std::min(t.x * kTileCells + kTileCells - 1, static_cast<int>(std::floor(exposed.right() / cellSize_)));
+    const int y0 = std::max(t.y * kTileCells, static_cast<int>(std::floor(exposed.top() / cellSize_)));
+    const int y1 = std::min(t.y * kTileCells + kTileCells - 1, static_cast<int>(std::floor(exposed.bottom() / cellSize_)));
+
+    for (int y = y0; y <= y1; ++y) {
+        for (int x = x0; x <= x1; ++x) {
+            const engine::Coord c{x, y};
+            if (board_->isFinite() && !board_->inBounds(c)) continue;
+            const engine::Player p = board_->get(c);
+            if (p == engine::Player::None) continue;
+            paintStone(painter, p, QRectF(x * cellSize_, y * cellSize_, cellSize_, cellSize_));
+        }
+    }
+}
+
+void StoneLayerItem::paintStone(QPainter* painter, engine::Player p, const QRectF& cellRect) {
+    painter->setRenderHint(QPainter::Antialiasing, true);
+
+    QPen pen(stoneColor(p));
+    pen.setWidthF(2.4);
+    painter->setPen(pen);
+    painter->setBrush(Qt::NoBrush);
+
+    const qreal m = cellRect.width() * 0.18; // margin
+    const QRectF r = cellRect.adjusted(m, m, -m, -m);
+
+    if (p == engine::Player::X) {
+        painter->drawLine(r.topLeft(), r.bottomRight());
+        painter->drawLine(r.topRight(), r.bottomLeft());
+    } else if (p == engine::Player::O) {
+        painter->drawEllipse(r);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TIKTAKTOE_STONELAYERITEM_H
+#define TIKTAKTOE_STONELAYERITEM_H
+#pragma once
+
+#include <QCache>
+#include <QGraphicsItem>
+#include <QImage>
+#include <QPixmap>
+#include <QRectF>
+
+#include <engine/Board.h>
+
+#include "TileIndex.h"
+
+// All stones of the board in one scene item. Paints only the tiles of kTileCells x kTileCells cells that meet the
+// exposed rect and hold a stone, reading the stones from the engine board; each tile is cached as a pixmap at the
+// current zoom, so the cost follows what is on screen rather than the length of the game.
+//
+// Zoomed out, the detail drops with the on-screen cell size: below kShapeMinPixels a tile is a raster of one pixel
+// per cell, below kRasterMinPixels a single square shaded by how full the tile is and whose stones dominate.
+class StoneLayerItem : public QGraphicsItem {
+public:
+    static constexpr int kTileCells = 16;
+    static constexpr qreal kShapeMinPixels = 6.0;  // per cell
+    static constexpr qreal kRasterMinPixels = 1.0;
+
+    StoneLayerItem(const QRectF& rect, int cellSizePx);
+
+    QRectF boundingRect() const override { return rect_; }
+    void paint(QPainter* painter, const QStyleOptionGraphicsItem* option, QWidget* widget) override;
+
+    void setRect(const QRectF& r);
+
+    // The board must outlive the item or be replaced with setBoard() (rebuilds the tile index).
+    void setBoard(const engine::IBoard* board);
+    void stonePlaced(engine::Coord c);
+    void stoneRemoved(engine::Coord c);
+
+    static void paintStone(QPainter* painter, engine::Player p, const QRectF& cellRect);
+
+private:
+    struct Tile {
+        int x = 0;
+        int o = 0;
+        QImage raster; // one pixel per cell, built on first use and then patched per move
+    };
+
+    struct CachedTile {
+        QPixmap pixmap;
+        qreal scale = 0; // device pixels per scene unit it was rendered at
+    };
+
+    using Tiles = TileIndex<Tile, kTileCells>;
+
+    QRectF tileRect(engine::Coord t) const;
+    void refreshTile(engine::Coord t);
+    void fillRaster(engine::Coord t, Tile& tile) const;
+    void paintTile(QPainter* painter, engine::Coord t, const QRectF& exposed, qreal scale);
+    void paintCells(QPainter* painter, engine::Coord t, const QRectF& exposed) const;
+    void paintDensity(QPainter* painter, engine::Coord t, const Tile& tile) const;
+
+    QRectF rect_;
+    int cellSize_ = 40;
+    const engine::IBoard* board_ = nullptr;
+
+    Tiles tiles_;                       // non-empty tiles only
+    QCache<quint64, CachedTile> cache_; // cost = pixels
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef TIKTAKTOE_TILEINDEX_H
+#define TIKTAKTOE_TILEINDEX_H
+#pragma once
+
+#include <QRectF>
+
+#include <cmath>
+#include <cstddef>
+#include <unordered_map>
+
+#include <engine/Board.h>
+
+// Per-tile data of a scene layer, keyed by tiles of Cells x Cells board cells. Layers keep only non-empty tiles and
+// paint through forEachVisible(), so a repaint costs the tiles on screen, not the size of the board.
+template <class T, int Cells>
+class TileIndex {
+public:
+    static constexpr int kCells = Cells;
+
+    using Map = std::unordered_map<engine::Coord, T, engine::CoordHash>;
+
+    static int floorDiv(int a, int b) noexcept { return a >= 0 ? a / b : -((-a + b - 1) / b); }
+    static engine::Coord tileOf(engine::Coord c) noexcept { return engine::Coord{floorDiv(c.x, Cells), floorDiv(c.y, Cells)}; }
+
+    static QRectF tileRect(engine::Coord t, int cellSize) {
+        const qreal span = static_cast<qreal>(Cells) * cellSize;
+        return QRectF(t.x * span, t.y * span, span, span);
+    }
+
+    T& operator[](engine::Coord t) { return tiles_[t]; }
+    typename Map::iterator find(engine::Coord t) { return tiles_.find(t); }
+    typename Map::iterator erase(typename Map::iterator it) { return tiles_.erase(it); }
+    std::size_t erase(engine::Coord t) { return tiles_.erase(t); }
+    typename Map::iterator begin() { return tiles_.begin(); }
+    typename Map::iterator end() { return tiles_.end(); }
+    typename Map::const_iterator begin() const { return tiles_.begin(); }
+    typename Map::const_iterator end() const { return tiles_.end(); }
+    bool empty() const noexcept { return tiles_.empty(); }
+    std::size_t size() const noexcept { return tiles_.size(); }
+    void clear() { tiles_.clear(); }
+
+    // Calls fn(tile coord, T&) for every stored tile that meets `exposed` (scene units).
+    template <class Fn>
+    void forEachVisible(const QRectF& exposed, int cellSize, Fn&& fn) {
+        const qreal span = static_cast<qreal>(Cells) * cellSize;
+        const int tx0 = static_cast<int>(std::floor(exposed.left() / span));
+        const int tx1 = static_cast<int>(std::floor(exposed.right() / span));
+        const int ty0 = static_cast<int>(std::floor(exposed.top() / span));
+        const int ty1 = static_cast<int>(std::floor(exposed.bottom() / span));
+
+        // Обходим меньшее из двух: видимые плитки или непустые.
+        const long long visible = static_cast<long long>(tx1 - tx0 + 1) * (ty1 - ty0 + 1);
+        if (visible <= static_cast<long long>(tiles_.size())) {
+            for (int ty = ty0; ty <= ty1; ++ty) {
+                for (int tx = tx0; tx <= tx1; ++tx) {
+                    auto it = tiles_.find(engine::Coord{tx, ty});
+                    if (it != tiles_.end()) fn(it->first, it->second);
+                }
+            }
+        } else {
+            for (auto& [t, tile] : tiles_) {
+                if (t.x >= tx0 && t.x <= tx1 && t.y >= ty0 && t.y <= ty1) fn(t, tile);
+            }
+        }
+    }
+
+private:
+    Map tiles_;
+};
+
+#endif
@@ -49,6 +49,13 @@ int main(int argc, char** argv) {
 
     parser.addOption(QCommandLineOption("ai-radius", "AI search radius around existing moves (default 2).", "int"));
 
+    parser.addOption(QCommandLineOption("ponder", "Let the AI think on the human's time (default)."));
+    parser.addOption(QCommandLineOption("no-ponder", "Do not think on the human's time."));
+
+    parser.addOption(QCommandLineOption("tablebase", "Endgame tablebase file built by tablebase_gen.", "file"));
+
+    parser.addOption(QCommandLineOption("opening-book", "Opening book file built by opening_book_gen.", "file"));
+
     parser.addOption(QCommandLineOption("cell-size", "Cell size in pixels (default 40).", "int"));
 
     parser.process(app);
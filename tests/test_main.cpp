@@ -1,7 +1,33 @@
+#include <engine/AI.h>
+#include <engine/CandidateScratch.h>
 #include <engine/CellValueFunction.h>
+#include <engine/Classic3x3Table.h>
+#include <engine/EndgameSolver.h>
+#include <engine/FiniteBoard.h>
+#include <engine/FrontierMaps.h>
 #include <engine/GameState.h>
+#include <engine/InfiniteBoard.h>
+#include <engine/LinePatterns.h>
+#include <engine/OpeningBook.h>
+#include <engine/OverlayBoard.h>
+#include <engine/PnSolver.h>
+#include <engine/ScoreBounds.h>
+#include <engine/Scoring.h>
+#include <engine/Symmetry.h>
+#include <engine/Tablebase.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
 #include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #define CHECK(cond)                                                                 \
     do {                                                                            \
@@ -123,6 +149,1061 @@ int main() {
         CHECK(!res.ok);
     }
 
+    // 5) df-pn solver: 3x3 and 4x4 (N=4) are draws, a forced win is found and played
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 3;
+        rules.height = 3;
+        rules.N = 3;
+        rules.classicWin = true;
+        rules.maximizeLines = false;
+
+        GameState g(rules, GameState::createBoard(rules));
+        PnSolver solver;
+        CHECK(solver.solve(g) == SolveValue::Draw);
+
+        CHECK(g.tryMakeMove({1, 1}).ok); // X
+        CHECK(g.tryMakeMove({1, 0}).ok); // O (edge reply loses)
+        CHECK(solver.solve(g) == SolveValue::Win);
+
+        SolveValue v = SolveValue::Unknown;
+        auto mv = solver.bestMove(g, Player::X, &v);
+        CHECK(mv.has_value());
+        CHECK(v == SolveValue::Win);
+
+        // AI keeps the win through to the end.
+        SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 1});
+        while (!g.isGameOver()) {
+            auto m = ai.chooseMove(g, g.currentPlayer());
+            CHECK(m.has_value());
+            CHECK(g.tryMakeMove(*m).ok);
+        }
+        CHECK(g.result() == GameResult::WinX);
+
+        rules.width = 4;
+        rules.height = 4;
+        rules.N = 4;
+        GameState g4(rules, GameState::createBoard(rules));
+        CHECK(solver.solve(g4) == SolveValue::Draw);
+
+        // Старое имя настройки всё ещё выключает решатель; 5x5 по умолчанию ему не отдаётся.
+        SimpleAI::Settings old;
+        old.seed = 1;
+        old.enablePerfectClassic3x3 = false;
+        SimpleAI heuristic(old);
+        CHECK(heuristic.chooseMove(g4, Player::X).has_value());
+        CHECK(heuristic.lastStats().source == MoveSource::Heuristic);
+
+        rules.width = 5;
+        rules.height = 5;
+        GameState g5(rules, GameState::createBoard(rules));
+        CHECK(ai.chooseMove(g5, Player::X).has_value());
+        CHECK(ai.lastStats().source == MoveSource::Heuristic);
+    }
+
+    // 6) Compile-time 3x3 table agrees with the df-pn solver on every live position
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 3;
+        rules.height = 3;
+        rules.N = 3;
+        rules.classicWin = true;
+        rules.maximizeLines = false;
+
+        PnSolver solver;
+        int checked = 0;
+        for (int idx = 0; idx < kClassic3x3Positions; ++idx) {
+            std::vector<Coord> xs;
+            std::vector<Coord> os;
+            int rest = idx;
+            for (int i = 0; i < 9; ++i) {
+                if (rest % 3 == 1) xs.push_back({i % 3, i / 3});
+                if (rest % 3 == 2) os.push_back({i % 3, i / 3});
+                rest /= 3;
+            }
+            if (xs.size() != os.size() && xs.size() != os.size() + 1) continue;
+
+            GameState g(rules, GameState::createBoard(rules));
+            bool live = true;
+            for (std::size_t i = 0; i < xs.size() && live; ++i) {
+                live = g.tryMakeMove(xs[i]).ok && !g.isGameOver();
+                if (live && i < os.size()) live = g.tryMakeMove(os[i]).ok && !g.isGameOver();
+            }
+            if (!live) continue;
+
+            const Classic3x3Entry& e = classic3x3Lookup(idx);
+            const SolveValue v = solver.solve(g);
+            CHECK(e.move <= 8);
+            CHECK((e.score > 0) == (v == SolveValue::Win));
+            CHECK((e.score < 0) == (v == SolveValue::Loss));
+            ++checked;
+        }
+        CHECK(checked > 4000);
+    }
+
+    // 7) Tablebase: retrograde values match known results and are realised by bestMove
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 3;
+        rules.height = 3;
+        rules.N = 3;
+        rules.classicWin = true;
+        rules.maximizeLines = false;
+
+        const auto path = (std::filesystem::temp_directory_path() / "advanced_ttt_test.tb").string();
+
+        CHECK(Tablebase::generate(rules, path, 2));
+        {
+            Tablebase tb;
+            CHECK(tb.open(path));
+
+            GameState g(rules, GameState::createBoard(rules));
+            CHECK(tb.matches(g.rules()));
+            CHECK(tb.probe(g) == 0);
+
+            CHECK(g.tryMakeMove({1, 1}).ok);
+            CHECK(g.tryMakeMove({1, 0}).ok);
+            const auto v = tb.probe(g);
+            CHECK(v.has_value() && *v > Tablebase::kWinValue);
+
+            RuleSet other = rules;
+            other.N = 2;
+            CHECK(!tb.matches(other));
+        }
+
+        rules.classicWin = false;
+        rules.maximizeLines = true;
+        CHECK(Tablebase::generate(rules, path, 3));
+        {
+            auto tb = std::make_shared<Tablebase>();
+            CHECK(tb->open(path));
+
+            GameState g(rules, GameState::createBoard(rules));
+            const auto start = tb->probe(g);
+            CHECK(start.has_value());
+
+            SimpleAI ai;
+            ai.setTablebase(tb);
+            while (!g.isGameOver()) {
+                auto m = ai.chooseMove(g, g.currentPlayer());
+                CHECK(m.has_value());
+                CHECK(g.tryMakeMove(*m).ok);
+            }
+
+            const auto x = Scoring::computeTotals(g.board(), Player::X, g.rules());
+            const auto o = Scoring::computeTotals(g.board(), Player::O, g.rules());
+            CHECK(static_cast<long long>(x.lines - o.lines) == *start);
+        }
+
+        std::filesystem::remove(path);
+    }
+
+    // 8) Endgame solver: exact margins agree with the tablebase, timeouts are reported as inexact
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 4;
+        rules.height = 3;
+        rules.N = 3;
+        rules.classicWin = false;
+        rules.maximizeLines = true;
+        rules.weightsEnabled = true;
+        rules.weightFunction.type = CellValueFunction::Type::Manhattan;
+        rules.weightFunction.scale = 1;
+        rules.weightFunction.offset = 1;
+
+        const auto path = (std::filesystem::temp_directory_path() / "advanced_ttt_endgame.tb").string();
+        CHECK(Tablebase::generate(rules, path, 2));
+        Tablebase tb;
+        CHECK(tb.open(path));
+
+        EndgameSolver solver(EndgameSolver::Settings{std::size_t{1} << 16, 2});
+
+        GameState g(rules, GameState::createBoard(rules));
+        const Coord line[] = {{0, 0}, {1, 1}, {3, 2}, {2, 0}};
+        for (const Coord c : line) {
+            const auto r = solver.solve(g, g.currentPlayer(), SearchLimits{});
+            CHECK(r.exact && r.move.has_value());
+            CHECK(tb.probe(g) == r.value);
+            CHECK(g.tryMakeMove(c).ok);
+        }
+        tb.close();
+        std::filesystem::remove(path);
+
+        rules.width = 6;
+        rules.height = 6;
+        rules.N = 4;
+        GameState big(rules, GameState::createBoard(rules));
+        const auto r = solver.solve(big, Player::X, SearchLimits::within(std::chrono::milliseconds(0)));
+        CHECK(!r.exact && r.rootsFinished < r.rootsTotal);
+        CHECK(EndgameSolver::remainingMoves(big) == 36 && EndgameSolver::emptyCells(big) == 36);
+
+        // Почти ни один корень не досчитан — играет эвристика, а не случайный досчитанный ход.
+        SimpleAI::Settings hurried;
+        hurried.seed = 8;
+        hurried.endgameMaxEmpties = 36;
+        hurried.endgameTimeMs = 1;
+        SimpleAI rushed(hurried);
+        CHECK(rushed.chooseMove(big, Player::X).has_value());
+        CHECK(rushed.lastStats().source == MoveSource::Heuristic);
+
+        // Лимит ходов укорачивает партию, но не сужает перебор: порог — по пустым клеткам.
+        RuleSet limited;
+        limited.width = 15;
+        limited.height = 15;
+        limited.N = 5;
+        limited.classicWin = false;
+        limited.maximizeLines = true;
+        limited.maxMoves = 30;
+        GameState wide(limited, GameState::createBoard(limited));
+        for (int i = 0; i < 16; ++i) CHECK(wide.tryMakeMove({i % 15, 7 + i / 15}).ok);
+        CHECK(EndgameSolver::remainingMoves(wide) == 14 && EndgameSolver::emptyCells(wide) == 209);
+        SimpleAI gated(SimpleAI::Settings{2, 600, 40, 40, true, true, 8});
+        CHECK(gated.chooseMove(wide, wide.currentPlayer()).has_value());
+        CHECK(gated.lastStats().source == MoveSource::Heuristic);
+    }
+
+    // 9) Anytime chooseMove: every limit still yields a legal move, and the stop flag / node budget are honoured
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = false;
+        rules.maximizeLines = true;
+        rules.weightsEnabled = true;
+        rules.weightFunction.type = CellValueFunction::Type::Manhattan;
+
+        GameState g(rules, GameState::createBoard(rules));
+        const Coord opening[] = {{0, 0}, {1, 1}, {2, 0}, {3, 3}, {1, -1}, {-2, 2}};
+        for (const Coord c : opening) CHECK(g.tryMakeMove(c).ok);
+
+        SimpleAI ai(SimpleAI::Settings{3, 600, 40, 40, true, true, 7});
+
+        std::atomic<bool> stop{true};
+        SearchLimits cancelled;
+        cancelled.stop = &stop;
+        const auto a = ai.chooseMove(g, g.currentPlayer(), cancelled);
+        CHECK(a.has_value() && g.isMoveLegal(*a));
+
+        SearchLimits few;
+        few.maxNodes = 10;
+        const auto b = ai.chooseMove(g, g.currentPlayer(), few);
+        CHECK(b.has_value() && g.isMoveLegal(*b));
+
+        const auto c = ai.chooseMove(g, g.currentPlayer(), SearchLimits::within(std::chrono::milliseconds(0)));
+        CHECK(c.has_value() && g.isMoveLegal(*c));
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const auto d = ai.chooseMove(g, g.currentPlayer(), SearchLimits::within(std::chrono::milliseconds(20)));
+        CHECK(d.has_value() && g.isMoveLegal(*d));
+        CHECK(std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(500));
+    }
+
+    // 10) Search statistics describe the call that produced the move
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = true;
+        rules.maximizeLines = false;
+
+        GameState g(rules, GameState::createBoard(rules));
+        CHECK(g.tryMakeMove({0, 0}).ok);
+        CHECK(g.tryMakeMove({5, 5}).ok);
+
+        SimpleAI ai(SimpleAI::Settings{2, 600, 10, 40, true, true, 3});
+        int calls = 0;
+        MoveSource reported = MoveSource::None;
+        ai.setStatsCallback([&](const SearchStats& st) {
+            ++calls;
+            reported = st.source;
+        });
+
+        const auto m = ai.chooseMove(g, Player::X);
+        const SearchStats& st = ai.lastStats();
+        CHECK(m.has_value() && st.move == m);
+        CHECK(calls == 1 && reported == MoveSource::Heuristic);
+        CHECK(st.legalMoves > 0 && st.legalMoves <= st.candidatesGenerated);
+        CHECK(st.topMoves == 10 && st.secondPlyMoves == 10);
+        CHECK(st.classicEvals == st.nodes && st.scoreEvals == 0);
+        CHECK(st.classicEvals == st.legalMoves + st.secondPlyReplies);
+        CHECK(st.breakdown.total == st.breakdown.firstPly - st.breakdown.opponentBest * st.breakdown.defenseMul + st.breakdown.noise);
+        CHECK(!st.limitHit);
+        CHECK(st.totalTime >= st.firstPlyTime + st.secondPlyTime);
+        CHECK(toString(st).find("source=heuristic") == 0);
+
+        rules.topology = BoardTopology::Finite;
+        rules.width = 4;
+        rules.height = 4;
+        rules.N = 4;
+        GameState small(rules, GameState::createBoard(rules));
+        ai.setStatsCallback(nullptr);
+        CHECK(ai.chooseMove(small, Player::X).has_value());
+        CHECK(ai.lastStats().source == MoveSource::ClassicSolver);
+        CHECK(ai.lastStats().cacheProbes > 0 && ai.lastStats().cacheHitRate() > 0.0);
+    }
+
+    // 11) Line pattern tables give the same potential as walking the lines (table for N<=8, scan above)
+    {
+        auto reference = [](const IBoard& b, Player p, Coord c, int N) {
+            LinePotential pot;
+            const int dirs[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+            for (const auto& d : dirs) {
+                int len = 1;
+                int open = 0;
+                for (int s = -1; s <= 1; s += 2) {
+                    Coord t{c.x + s * d[0], c.y + s * d[1]};
+                    while (b.inBounds(t) && b.get(t) == p) {
+                        ++len;
+                        t = Coord{t.x + s * d[0], t.y + s * d[1]};
+                    }
+                    if (b.inBounds(t) && b.get(t) == Player::None) ++open;
+                }
+                if (len >= N) pot.canWin = true;
+                pot.value += LinePatterns::directionValue(len, open, N);
+            }
+            return pot;
+        };
+
+        std::mt19937 rng(11);
+        for (const int N : {3, 5, 10}) {
+            RuleSet rules;
+            rules.topology = BoardTopology::Finite;
+            rules.width = 12;
+            rules.height = 12;
+            rules.N = N;
+            GameState g(rules, GameState::createBoard(rules));
+            CHECK(g.linePatterns().N() == N);
+
+            int moves = 0;
+            while (moves < 70 && !g.isGameOver()) {
+                if (g.tryMakeMove({static_cast<int>(rng() % 12), static_cast<int>(rng() % 12)}).ok) ++moves;
+            }
+
+            for (int y = 0; y < 12; ++y) {
+                for (int x = 0; x < 12; ++x) {
+                    if (!g.board().isEmpty({x, y})) continue;
+                    for (const Player p : {Player::X, Player::O}) {
+                        const LinePotential a = g.linePatterns().potentialAt(g.board(), p, {x, y});
+                        const LinePotential b = reference(g.board(), p, {x, y}, N);
+                        CHECK(a.canWin == b.canWin);
+                        CHECK(a.value == b.value);
+                    }
+                }
+            }
+        }
+    }
+
+    // 12) Frontier maps stay equal to a fresh evaluation through moves, undo and redo
+    {
+        std::mt19937 rng(12);
+        for (const BoardTopology topo : {BoardTopology::Finite, BoardTopology::Infinite}) {
+            RuleSet rules;
+            rules.topology = topo;
+            rules.width = 9;
+            rules.height = 9;
+            rules.N = 4;
+            rules.weightsEnabled = true;
+            rules.weightFunction.type = CellValueFunction::Type::Manhattan;
+            GameState g(rules, GameState::createBoard(rules));
+            CHECK(g.frontier().enabled());
+
+            for (int step = 0; step < 120 && !g.isGameOver(); ++step) {
+                const int r = static_cast<int>(rng() % 10);
+                if (r < 2) {
+                    g.undo();
+                } else if (r < 3) {
+                    g.redo();
+                } else {
+                    g.tryMakeMove({static_cast<int>(rng() % 9), static_cast<int>(rng() % 9)});
+                }
+
+                const IBoard& b = g.board();
+                std::unordered_set<Coord, CoordHash> expected;
+                for (const auto& [cell, owner] : b.occupied()) {
+                    (void)owner;
+                    for (int dy = -2; dy <= 2; ++dy) {
+                        for (int dx = -2; dx <= 2; ++dx) {
+                            const Coord c{cell.x + dx, cell.y + dy};
+                            if (b.isFinite() && !b.inBounds(c)) continue;
+                            if (b.isEmpty(c)) expected.insert(c);
+                        }
+                    }
+                }
+                CHECK(g.frontier().cells().size() == expected.size());
+
+                for (const Coord c : expected) {
+                    const FrontierCell* fc = g.frontier().find(c);
+                    CHECK(fc != nullptr);
+                    for (const Player p : {Player::X, Player::O}) {
+                        const MoveDelta d = Scoring::computeMoveDelta(b, c, p, g.rules());
+                        CHECK(fc->of(p).delta.linesDelta == d.linesDelta);
+                        CHECK(fc->of(p).delta.scoreDelta == d.scoreDelta);
+                        CHECK(fc->of(p).potential.value == g.linePatterns().potentialAt(b, p, c).value);
+                    }
+                }
+            }
+        }
+    }
+
+    // 13) Overlay board reads through to the base, and the AI gives the same moves without copying the board
+    {
+        InfiniteBoard base;
+        CHECK(base.set({0, 0}, Player::X));
+        CHECK(base.set({1, 0}, Player::O));
+
+        OverlayBoard ov(base);
+        CHECK(ov.get({0, 0}) == Player::X);
+        CHECK(!ov.set({0, 0}, Player::O));
+        CHECK(ov.set({5, 5}, Player::O));
+        CHECK(ov.clear({1, 0}));
+        CHECK(ov.get({5, 5}) == Player::O);
+        CHECK(ov.get({1, 0}) == Player::None);
+        CHECK(base.get({5, 5}) == Player::None);
+        CHECK(base.get({1, 0}) == Player::O);
+        CHECK(ov.occupied().size() == 2);
+
+        // Копия сплющена в обычную доску: изменения базы её не задевают.
+        const auto flat = ov.clone();
+        CHECK(dynamic_cast<const OverlayBoard*>(flat.get()) == nullptr && !flat->isFinite());
+        CHECK(base.set({7, 7}, Player::X));
+        CHECK(flat->get({7, 7}) == Player::None && flat->get({5, 5}) == Player::O && flat->get({1, 0}) == Player::None);
+        CHECK(base.clear({7, 7}));
+
+        CHECK(ov.set({1, 0}, Player::O));
+        CHECK(ov.clear({5, 5}));
+        CHECK(ov.changeCount() == 0);
+
+        FiniteBoard small(3, 3);
+        OverlayBoard fov(small);
+        CHECK(!fov.set({3, 0}, Player::X));
+        CHECK(fov.set({2, 2}, Player::X));
+        CHECK(!fov.clear({0, 0}));
+        const auto fflat = fov.clone();
+        CHECK(fflat->isFinite() && fflat->width() == 3 && fflat->get({2, 2}) == Player::X);
+
+        std::mt19937 rng(13);
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        GameState g(rules, GameState::createBoard(rules));
+        GameState plain(rules, GameState::createBoard(rules));
+        plain.setFrontierRadius(0);
+        CHECK(!plain.frontier().enabled());
+        int placed = 0;
+        while (placed < 30) {
+            const Coord c{static_cast<int>(rng() % 12), static_cast<int>(rng() % 12)};
+            if (!g.tryMakeMove(c).ok) continue;
+            if (g.isGameOver()) {
+                g.undo();
+                continue;
+            }
+            CHECK(plain.tryMakeMove(c).ok);
+            ++placed;
+        }
+
+        SimpleAI withFrontier(SimpleAI::Settings{2, 600, 40, 40, true, true, 5});
+        SimpleAI withScan(SimpleAI::Settings{2, 600, 40, 40, true, true, 5});
+        const auto a = withFrontier.chooseMove(g, g.currentPlayer());
+        const auto b = withScan.chooseMove(plain, plain.currentPlayer());
+        CHECK(a && b && *a == *b);
+        CHECK(withFrontier.lastStats().secondPlyReplies == withScan.lastStats().secondPlyReplies);
+        CHECK(g.board().occupied().size() == 30);
+    }
+
+    // 14) Line candidates rank by threat: a far block survives truncation that keeps only cells near the last move
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        GameState g(rules, GameState::createBoard(rules));
+        const Coord xs[] = {{0, 0}, {1, 0}, {2, 0}, {3, 0}, {20, 20}};
+        const Coord os[] = {{-1, 0}, {10, -10}, {12, -14}, {14, -10}};
+        for (int i = 0; i < 5; ++i) {
+            CHECK(g.tryMakeMove(xs[i]).ok);
+            if (i < 4) CHECK(g.tryMakeMove(os[i]).ok);
+        }
+        CHECK(!g.isGameOver());
+
+        SimpleAI::Settings narrow{2, 4, 4, 4, true, true, 1};
+        SimpleAI lines(narrow);
+        const auto mv = lines.chooseMove(g, Player::O);
+        CHECK(mv && *mv == (Coord{4, 0}));
+        CHECK(lines.lastStats().candidatesGenerated <= 4);
+
+        narrow.lineCandidates = false;
+        SimpleAI square(narrow);
+        const auto far = square.chooseMove(g, Player::O);
+        CHECK(far && *far != (Coord{4, 0}));
+
+        // Тихая позиция (ни один ход не даёт N-2 в ряд) — кандидаты до N-1 по линиям; иначе только радиус 2.
+        auto reaches = [](const GameState& s, Coord c) {
+            SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 1});
+            const auto all = ai.rankMoves(s, s.currentPlayer(), 600);
+            return std::find(all.begin(), all.end(), c) != all.end();
+        };
+        GameState quiet(rules, GameState::createBoard(rules));
+        CHECK(quiet.tryMakeMove(Coord{0, 0}).ok);
+        CHECK(quiet.tryMakeMove(Coord{10, 10}).ok);
+        CHECK(reaches(quiet, Coord{0, 4}) && !reaches(quiet, Coord{0, 5}));
+
+        CHECK(quiet.tryMakeMove(Coord{1, 0}).ok); // X(2,0) теперь даёт тройку
+        CHECK(quiet.tryMakeMove(Coord{10, 11}).ok);
+        CHECK(reaches(quiet, Coord{0, 2}) && !reaches(quiet, Coord{0, 3}) && !reaches(quiet, Coord{0, 4}));
+    }
+
+    // 15) Stamped candidate sets and bucket sort match a hash set with a full sort (dense box, tiles, reuse)
+    {
+        auto reference = [](const IBoard& b, int radius, Coord ref, std::size_t keep) {
+            std::unordered_set<Coord, CoordHash> set;
+            for (const auto& [s, p] : b.occupied()) {
+                (void)p;
+                for (int dy = -radius; dy <= radius; ++dy) {
+                    for (int dx = -radius; dx <= radius; ++dx) {
+                        const Coord c{s.x + dx, s.y + dy};
+                        if (b.isFinite() && !b.inBounds(c)) continue;
+                        if (b.isEmpty(c)) set.insert(c);
+                    }
+                }
+            }
+            std::vector<Coord> out(set.begin(), set.end());
+            std::sort(out.begin(), out.end(), [&](const Coord& a, const Coord& c) {
+                const long long da = std::llabs(static_cast<long long>(a.x) - ref.x) + std::llabs(static_cast<long long>(a.y) - ref.y);
+                const long long dc = std::llabs(static_cast<long long>(c.x) - ref.x) + std::llabs(static_cast<long long>(c.y) - ref.y);
+                if (da != dc) return da < dc;
+                if (a.y != c.y) return a.y < c.y;
+                return a.x < c.x;
+            });
+            if (keep > 0 && out.size() > keep) out.resize(keep);
+            return out;
+        };
+
+        std::mt19937 rng(15);
+        CandidateScratch scratch;
+        std::vector<Coord> got;
+        for (int round = 0; round < 40; ++round) {
+            const bool sparse = round % 4 == 3; // bounding box too large for the dense array
+            const int spread = sparse ? 4000 : 30;
+            InfiniteBoard b;
+            for (int i = 0; i < 25; ++i) {
+                const Coord c{static_cast<int>(rng() % (2 * spread)) - spread, static_cast<int>(rng() % (2 * spread)) - spread};
+                (void)b.set(c, i % 2 ? Player::O : Player::X);
+            }
+            const Coord ref{static_cast<int>(rng() % 20) - 10, static_cast<int>(rng() % 20) - 10};
+            const int radius = 1 + round % 3;
+            const std::size_t keep = round % 2 ? 0 : 37;
+
+            const auto cells = scratch.neighborhood(b, b.occupied(), radius, ref, keep);
+            got.assign(cells.begin(), cells.end());
+            CHECK(got == reference(b, radius, ref, keep));
+        }
+
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 15;
+        rules.height = 15;
+        GameState g(rules, GameState::createBoard(rules));
+        for (int i = 0; i < 20; ++i) g.tryMakeMove({static_cast<int>(rng() % 15), static_cast<int>(rng() % 15)});
+        const Coord last = g.lastMove().value_or(Coord{0, 0});
+        CHECK(g.generateCandidateMoves(2, 50) == reference(g.board(), 2, last, 50));
+        CHECK(g.generateCandidateMoves(1, 0) == reference(g.board(), 1, last, 0));
+        CHECK(g.generateCandidateMoves(2, 50, scratch) == reference(g.board(), 2, last, 50));
+
+        // Константная партия без общего буфера: два потока генерируют одновременно.
+        const GameState& shared = g;
+        std::vector<Coord> fromThread;
+        std::thread t([&]() {
+            CandidateScratch own;
+            for (int i = 0; i < 200; ++i) fromThread = shared.generateCandidateMoves(2, 50, own);
+        });
+        std::vector<Coord> here;
+        for (int i = 0; i < 200; ++i) here = shared.generateCandidateMoves(2, 0);
+        t.join();
+        CHECK(fromThread == reference(g.board(), 2, last, 50) && here == reference(g.board(), 2, last, 0));
+    }
+
+    // 16) Move deltas add up to the totals in every line mode, and a warmed-up arena serves a decision alone
+    {
+        std::mt19937 rng(16);
+        for (int mode = 0; mode < 3; ++mode) {
+            RuleSet rules;
+            rules.topology = BoardTopology::Finite;
+            rules.width = 9;
+            rules.height = 9;
+            rules.N = 3;
+            rules.lineMode = mode == 0 ? LineLengthMode::ExactN : LineLengthMode::AtLeastN;
+            rules.countSubsegments = mode == 2;
+            rules.weightsEnabled = true;
+            rules.weightFunction.type = CellValueFunction::Type::Manhattan;
+
+            FiniteBoard b(9, 9);
+            for (int i = 0; i < 60; ++i) {
+                const Coord c{static_cast<int>(rng() % 9), static_cast<int>(rng() % 9)};
+                const Player p = i % 2 ? Player::O : Player::X;
+                if (!b.isEmpty(c)) continue;
+                const LineTotals before = Scoring::computeTotals(b, p, rules);
+                const MoveDelta d = Scoring::computeMoveDelta(b, c, p, rules);
+                CHECK(b.set(c, p));
+                const LineTotals after = Scoring::computeTotals(b, p, rules);
+                CHECK(after.lines - before.lines == d.linesDelta);
+                CHECK(after.score - before.score == d.scoreDelta);
+            }
+        }
+
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        GameState g(rules, GameState::createBoard(rules));
+        for (int i = 0; i < 40 && !g.isGameOver(); ++i) {
+            g.tryMakeMove({static_cast<int>(rng() % 16), static_cast<int>(rng() % 16)});
+        }
+        CHECK(!g.isGameOver());
+
+        SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 16});
+        const auto first = ai.chooseMove(g, g.currentPlayer());
+        const auto second = ai.chooseMove(g, g.currentPlayer());
+        CHECK(first && second);
+        CHECK(ai.arena().spilled() == 0);
+
+        // Без фронта кандидаты по линиям собираются обходом камней — их список тоже в арене.
+        g.setFrontierRadius(0);
+        SimpleAI scan(SimpleAI::Settings{2, 600, 40, 40, true, true, 16});
+        CHECK(scan.chooseMove(g, g.currentPlayer()) && scan.chooseMove(g, g.currentPlayer()));
+        CHECK(scan.arena().spilled() == 0);
+    }
+
+    // 17) Rule symmetries, canonical hashes and symmetric root moves
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 5;
+        rules.height = 5;
+        rules.weightsEnabled = true;
+        rules.weightFunction.type = CellValueFunction::Type::Manhattan;
+        rules.weightFunction.originX = 2;
+        rules.weightFunction.originY = 2;
+        CHECK(BoardSymmetry::detect(rules, 5, 5).mask() == 0xff);
+
+        rules.weightFunction.originX = 1; // only the mirror in y keeps the weights
+        CHECK(BoardSymmetry::detect(rules, 5, 5).mask() == ((1u << 0) | (1u << 5)));
+
+        rules.weightsEnabled = false;
+        CHECK(BoardSymmetry::detect(rules, 4, 3).mask() == ((1u << 0) | (1u << 2) | (1u << 4) | (1u << 5)));
+        rules.topology = BoardTopology::Infinite;
+        CHECK(BoardSymmetry::detect(rules, 0, 0).trivial());
+
+        rules.topology = BoardTopology::Finite;
+        const BoardSymmetry sym = BoardSymmetry::detect(rules, 5, 5);
+        FiniteBoard a(5, 5);
+        CHECK(a.set({0, 1}, Player::X));
+        CHECK(a.set({3, 3}, Player::O));
+        CHECK(sym.stabilizer(a) == 1);
+        for (int t = 1; t < BoardSymmetry::kTransforms; ++t) {
+            FiniteBoard b(5, 5);
+            for (const auto& [c, p] : a.occupied()) CHECK(b.set(sym.apply(t, c), p));
+            CHECK(sym.canonicalHash(b) == sym.canonicalHash(a));
+            CHECK(sym.apply(BoardSymmetry::inverse(t), sym.apply(t, {1, 4})) == (Coord{1, 4}));
+        }
+        FiniteBoard c(5, 5);
+        CHECK(c.set({0, 1}, Player::O));
+        CHECK(c.set({3, 3}, Player::X));
+        CHECK(sym.canonicalHash(c) != sym.canonicalHash(a));
+
+        rules.width = 15;
+        rules.height = 15;
+        GameState g(rules, GameState::createBoard(rules));
+        CHECK(g.symmetry().mask() == 0xff);
+        CHECK(g.tryMakeMove({7, 7}).ok);
+        SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 17});
+        CHECK(ai.chooseMove(g, Player::O).has_value());
+        const SearchStats& st = ai.lastStats();
+        CHECK(st.symmetricSkipped > 0);
+        // Around a lone centre stone every orbit has 4 or 8 cells.
+        CHECK(st.legalMoves * 4 <= st.legalMoves + st.symmetricSkipped);
+        CHECK(st.legalMoves + st.symmetricSkipped <= st.legalMoves * 8);
+        CHECK(st.legalMoves < st.candidatesGenerated);
+    }
+
+    // 18) Opening book: symmetric variants share an entry, the AI plays book moves, other rules are ignored
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 9;
+        rules.height = 9;
+        rules.N = 4;
+
+        GameState g(rules, GameState::createBoard(rules));
+        CHECK(g.tryMakeMove({1, 2}).ok);
+        const auto path = (std::filesystem::temp_directory_path() / "advanced_ttt_test.book").string();
+        CHECK(OpeningBook::write(rules, {OpeningBook::makeEntry(g, {2, 2})}, 1, path));
+
+        auto book = std::make_shared<OpeningBook>();
+        CHECK(book->open(path));
+        CHECK(book->header().entryCount == 1);
+        CHECK(book->probe(g) == (Coord{2, 2}));
+
+        const BoardSymmetry& sym = g.symmetry();
+        for (int t = 1; t < BoardSymmetry::kTransforms; ++t) {
+            GameState r(rules, GameState::createBoard(rules));
+            CHECK(r.tryMakeMove(sym.apply(t, {1, 2})).ok);
+            CHECK(book->probe(r) == sym.apply(t, {2, 2}));
+        }
+
+        SimpleAI ai;
+        ai.setOpeningBook(book);
+        CHECK(ai.chooseMove(g, Player::O) == (Coord{2, 2}));
+        CHECK(ai.lastStats().source == MoveSource::OpeningBook);
+        // Ход из книги принадлежит O; за X она не играет.
+        CHECK(ai.chooseMove(g, Player::X).has_value());
+        CHECK(ai.lastStats().source != MoveSource::OpeningBook);
+
+        CHECK(g.tryMakeMove({2, 2}).ok);
+        CHECK(g.tryMakeMove({5, 5}).ok);
+        CHECK(!book->probe(g).has_value()); // past maxPly
+
+        RuleSet other = rules;
+        other.N = 5;
+        GameState o(other, GameState::createBoard(other));
+        CHECK(o.tryMakeMove({1, 2}).ok);
+        CHECK(!book->matches(other));
+        CHECK(!book->probe(o).has_value());
+
+        rules.topology = BoardTopology::Infinite;
+        book->close(); // the file is rewritten below
+        GameState inf(rules, GameState::createBoard(rules));
+        CHECK(inf.tryMakeMove({-40, 3}).ok);
+        CHECK(OpeningBook::write(rules, {OpeningBook::makeEntry(inf, {-39, 3})}, 4, path));
+        CHECK(book->open(path));
+        CHECK(book->probe(inf) == (Coord{-39, 3}));
+        GameState shifted(rules, GameState::createBoard(rules));
+        CHECK(shifted.tryMakeMove({3, -40}).ok);
+        CHECK(!book->probe(shifted).has_value());
+    }
+
+    // 19) Score bounds hold for random continuations, and a locked result is the one the game ends with
+    {
+        std::mt19937 rng(23);
+        auto randomRules = [&](int i) {
+            RuleSet r;
+            r.topology = BoardTopology::Finite;
+            r.width = 5 + i % 2;
+            r.height = 5;
+            r.N = 3 + i % 2;
+            r.classicWin = i % 5 == 0;
+            r.maximizeLines = i % 3 != 0;
+            r.lineMode = i % 4 == 1 ? LineLengthMode::ExactN : LineLengthMode::AtLeastN;
+            r.countSubsegments = i % 4 == 2;
+            r.weightsEnabled = i % 2 == 0;
+            r.weightFunction.type = i % 6 == 4 ? CellValueFunction::Type::Constant : CellValueFunction::Type::Manhattan;
+            r.weightFunction.constant = -1;
+            r.weightFunction.originX = 2;
+            r.weightFunction.originY = 2;
+            r.targetScore = i % 7 == 3 ? 60 : 0;
+            r.maxMoves = i % 3 == 1 ? 18 : 0;
+            r.moveCostsEnabled = i % 8 == 5;
+            r.costMode = CostMode::CostFromScore;
+            r.costFunction = CellValueFunction::constantFunc(1);
+            return r;
+        };
+
+        int locked = 0;
+        for (int i = 0; i < 48; ++i) {
+            const RuleSet rules = randomRules(i);
+            GameState g(rules, GameState::createBoard(rules));
+            const ScoreBounds bounds(rules, rules.width, rules.height);
+            const int stop = 4 + i % 12;
+
+            auto randomMove = [&]() {
+                for (;;) {
+                    const Coord c{static_cast<int>(rng() % 6), static_cast<int>(rng() % 5)};
+                    if (g.isMoveLegal(c)) return c;
+                }
+            };
+            while (!g.isGameOver() && g.moveCount() < stop) CHECK(g.tryMakeMove(randomMove()).ok);
+            if (g.isGameOver()) continue;
+
+            const ScoreBounds::Reach x = bounds.reach(g, Player::X);
+            const ScoreBounds::Reach o = bounds.reach(g, Player::O);
+            CHECK(x.minLines <= g.stats(Player::X).lines && g.stats(Player::X).lines <= x.maxLines);
+            const auto result = bounds.lockedResult(g);
+            if (result) ++locked;
+
+            while (!g.isGameOver()) CHECK(g.tryMakeMove(randomMove()).ok);
+            for (const auto& [p, r] : {std::pair{Player::X, x}, std::pair{Player::O, o}}) {
+                CHECK(r.minLines <= g.stats(p).lines && g.stats(p).lines <= r.maxLines);
+                CHECK(r.minScore <= g.stats(p).score && g.stats(p).score <= r.maxScore);
+                if (g.winner() == p && g.endReason() != EndReason::BoardFull && g.endReason() != EndReason::MoveLimit) {
+                    CHECK(r.canWin);
+                }
+            }
+            if (result) CHECK(*result == g.result());
+        }
+        CHECK(locked > 0);
+
+        // Lines race two moves before the move limit: X is three lines ahead and O cannot catch up.
+        RuleSet rules;
+        rules.topology = BoardTopology::Finite;
+        rules.width = 6;
+        rules.height = 6;
+        rules.N = 3;
+        rules.maximizeLines = true;
+        rules.maxMoves = 14;
+        GameState g(rules, GameState::createBoard(rules));
+        for (const Coord c : {Coord{0, 0}, Coord{5, 0}, Coord{1, 0}, Coord{5, 2}, Coord{2, 0}, Coord{0, 5},
+                              Coord{0, 2}, Coord{2, 5}, Coord{1, 2}, Coord{4, 4}, Coord{2, 2}, Coord{5, 4}}) {
+            CHECK(g.tryMakeMove(c).ok);
+        }
+        const ScoreBounds bounds(rules, 6, 6);
+        CHECK(g.stats(Player::X).lines >= 2);
+        CHECK(bounds.lockedResult(g) == GameResult::WinX);
+
+        const ScoreBounds::Reach x = bounds.reach(g, Player::X);
+        const ScoreBounds::Reach o = bounds.reach(g, Player::O);
+        EndgameSolver solver(EndgameSolver::Settings{1 << 12, 1});
+        const auto res = solver.solve(g, Player::X, SearchLimits{});
+        CHECK(res.exact && res.move.has_value());
+        // Without weights the margin is the line difference.
+        CHECK(res.value > 0 && x.minLines - o.maxLines <= res.value && res.value <= x.maxLines - o.minLines);
+
+        // Решённую гонку AI не перебирает: ни эндшпиля, ни второго уровня.
+        SimpleAI settled(SimpleAI::Settings{2, 600, 40, 40, true, true, 19});
+        CHECK(settled.chooseMove(g, Player::X).has_value());
+        CHECK(settled.lastStats().resultLocked && settled.lastStats().source == MoveSource::Heuristic);
+        CHECK(settled.lastStats().secondPlyMoves == 0 && settled.lastStats().solverNodes == 0);
+        GameState open(rules, GameState::createBoard(rules));
+        CHECK(settled.chooseMove(open, Player::X).has_value());
+        CHECK(!settled.lastStats().resultLocked && settled.lastStats().secondPlyMoves > 0);
+    }
+
+    // 20) A GameState copy is independent of the original and can be searched on another thread
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = true;
+        GameState g(rules, GameState::createBoard(rules));
+        for (const Coord c : {Coord{0, 0}, Coord{1, 1}, Coord{1, 0}, Coord{2, 2}}) CHECK(g.tryMakeMove(c).ok);
+
+        const GameState snap(g);
+        CHECK(snap.moveCount() == 4 && snap.board().get(Coord{1, 1}) == Player::O && snap.canUndo());
+
+        // Поиск по снимку идёт в другом потоке, пока партия продолжается.
+        std::vector<SearchProgress> progress;
+        std::optional<Coord> mv;
+        std::thread worker([&]() {
+            SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 1});
+            ai.setProgressCallback([&](const SearchProgress& p) { progress.push_back(p); });
+            mv = ai.chooseMove(snap, snap.currentPlayer());
+        });
+        CHECK(g.tryMakeMove(Coord{2, 0}).ok);
+        CHECK(g.undo() && g.undo());
+        worker.join();
+
+        CHECK(snap.moveCount() == 4 && snap.board().get(Coord{2, 0}) == Player::None);
+        CHECK(mv && snap.isMoveLegal(*mv));
+        CHECK(!progress.empty() && progress.front().ply == 1 && progress.back().ply == 2);
+        for (std::size_t i = 1; i < progress.size(); ++i) {
+            CHECK(progress[i].nodes >= progress[i - 1].nodes);
+            CHECK(progress[i].done <= progress[i].total);
+        }
+
+        // Копия и присваивание не делят доску и историю с оригиналом.
+        GameState copy = snap;
+        CHECK(copy.tryMakeMove(*mv).ok);
+        CHECK(snap.moveCount() == 4 && snap.board().isEmpty(*mv));
+        copy = g;
+        CHECK(copy.moveCount() == g.moveCount() && copy.canRedo() && copy.redo());
+        CHECK(copy.board().get(Coord{2, 2}) == Player::O && g.board().isEmpty(Coord{2, 2}));
+
+        // Поднятый флаг останова: поиск сразу отдаёт легальный ход.
+        std::atomic<bool> stop{true};
+        SearchLimits limits;
+        limits.stop = &stop;
+        SimpleAI ai;
+        const auto quick = ai.chooseMove(snap, snap.currentPlayer(), limits);
+        CHECK(quick && snap.isMoveLegal(*quick) && ai.lastStats().limitHit);
+    }
+
+    // 21) Ranked replies for pondering, and seeded moves are searched first
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = true;
+        GameState g(rules, GameState::createBoard(rules));
+        for (const Coord c : {Coord{0, 0}, Coord{0, 5}, Coord{1, 0}, Coord{2, 5}, Coord{2, 0}, Coord{4, 5}, Coord{3, 0},
+                              Coord{6, 5}}) {
+            CHECK(g.tryMakeMove(c).ok);
+        }
+
+        SimpleAI ai(SimpleAI::Settings{2, 600, 40, 40, true, true, 1});
+        const auto ranked = ai.rankMoves(g, Player::X, 5);
+        CHECK(ranked.size() == 5);
+        CHECK((ranked.front() == Coord{4, 0} || ranked.front() == Coord{-1, 0}));
+        for (std::size_t i = 0; i < ranked.size(); ++i) {
+            CHECK(g.isMoveLegal(ranked[i]));
+            for (std::size_t j = 0; j < i; ++j) CHECK(!(ranked[i] == ranked[j]));
+        }
+        CHECK(ai.rankMoves(g, Player::X, 0).empty());
+
+        // С бюджетом в одну оценку успевает только первый кандидат — подсказка, даже далёкая от камней.
+        SearchLimits one;
+        one.maxNodes = 1;
+        const Coord seed{20, 20};
+        CHECK(ai.chooseMove(g, Player::X, one, {seed}) == seed);
+        CHECK(ai.chooseMove(g, Player::X, one, {Coord{0, 0}, ranked[2]}) == ranked[2]); // занятая клетка пропущена
+
+        // Лимит во время второго уровня: первым сравнён подсказанный ход, а не лучший по первому уровню.
+        CHECK(ai.chooseMove(g, Player::X) == ranked.front());
+        const SearchStats full = ai.lastStats();
+        SearchLimits partial;
+        partial.maxNodes = full.legalMoves + full.secondPlyReplies / full.secondPlyMoves * 3 / 2;
+        CHECK(ai.chooseMove(g, Player::X, partial, {ranked[2]}) == ranked[2]);
+        CHECK(ai.lastStats().limitHit && ai.lastStats().secondPlyMoves == 1);
+
+        // maxTopMoves не отсекает подсказку, даже слабую по первому уровню.
+        SimpleAI top1(SimpleAI::Settings{2, 600, 1, 40, true, true, 1});
+        CHECK(top1.chooseMove(g, Player::X, SearchLimits{}, {seed}) == seed);
+        CHECK(top1.lastStats().topMoves == 1);
+    }
+
+    // 22) Per-cell scores match the ranking and ignore the distance to the last move
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = true;
+        GameState g(rules, GameState::createBoard(rules));
+        for (const Coord c : {Coord{0, 0}, Coord{0, 5}, Coord{1, 0}, Coord{2, 5}, Coord{2, 0}, Coord{4, 5}, Coord{3, 0},
+                              Coord{6, 5}}) {
+            CHECK(g.tryMakeMove(c).ok);
+        }
+
+        SimpleAI ai;
+        const auto win = ai.scoreCell(g, Player::X, Coord{4, 0});
+        const auto quiet = ai.scoreCell(g, Player::X, Coord{1, 2});
+        CHECK(win.legal && quiet.legal && win.move > quiet.move && win.own > quiet.own);
+        CHECK(!ai.scoreCell(g, Player::X, Coord{0, 0}).legal);
+
+        // Потенциалы сторон меняются местами; далёкие клетки не штрафуются за расстояние до последнего хода.
+        const auto block = ai.scoreCell(g, Player::O, Coord{4, 0});
+        CHECK(block.own == win.opponent && block.opponent == win.own);
+        CHECK(ai.scoreCell(g, Player::X, Coord{100, 100}).move == ai.scoreCell(g, Player::X, Coord{-300, 40}).move);
+    }
+
+    // 23) Multi-PV: one search gives the top moves with their replies, the first is the move chooseMove plays
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 5;
+        rules.classicWin = true;
+        GameState g(rules, GameState::createBoard(rules));
+        for (const Coord c : {Coord{0, 0}, Coord{1, 1}, Coord{1, 0}, Coord{2, 2}, Coord{5, 5}, Coord{-3, 2}}) {
+            CHECK(g.tryMakeMove(c).ok);
+        }
+
+        SimpleAI::Settings s;
+        s.seed = 7;
+        SimpleAI ai(s);
+        SimpleAI same(s);
+        const auto lines = ai.analyse(g, Player::X, 4);
+        const auto played = same.chooseMove(g, Player::X);
+
+        CHECK(lines.size() == 4);
+        CHECK(played && lines.front().move == *played);
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            CHECK(g.isMoveLegal(lines[i].move));
+            CHECK(lines[i].pv.size() == 2 && lines[i].pv.front() == lines[i].move);
+            CHECK(!(lines[i].pv[1] == lines[i].move) && g.board().isEmpty(lines[i].pv[1]));
+            if (i > 0) CHECK(lines[i - 1].score >= lines[i].score && !(lines[i - 1].move == lines[i].move));
+        }
+        CHECK(ai.lastStats().move == lines.front().move);
+
+        // Готовый ход из решателя 3x3 приходит один, без вариантов.
+        RuleSet classic;
+        classic.width = 3;
+        classic.height = 3;
+        classic.N = 3;
+        classic.classicWin = true;
+        GameState small(classic, GameState::createBoard(classic));
+        const auto only = ai.analyse(small, Player::X, 3);
+        CHECK(only.size() == 1 && only.front().pv.size() == 1);
+    }
+
+    // 24) Change feed: one batch per operation with consecutive seqs, enough to mirror the board without reading it
+    {
+        RuleSet rules;
+        rules.topology = BoardTopology::Infinite;
+        rules.N = 3;
+        rules.classicWin = false;
+        rules.maximizeLines = true;
+        GameState g(rules, GameState::createBoard(rules));
+
+        const std::uint64_t seq0 = g.changeSeq(); // newGame конструктора — тоже операция
+        std::vector<ChangeBatch> batches;
+        std::unordered_map<Coord, Player, CoordHash> mirror;
+        const int id = g.subscribe([&](const ChangeBatch& b) {
+            batches.push_back(b);
+            if (b.reset) mirror.clear();
+            for (const CellChange& ch : b.cells) {
+                if (ch.set()) mirror[ch.coord] = ch.player;
+                else mirror.erase(ch.coord);
+            }
+        });
+        auto mirrored = [&]() {
+            if (mirror.size() != g.board().occupied().size()) return false;
+            for (const auto& [c, p] : g.board().occupied()) {
+                const auto it = mirror.find(c);
+                if (it == mirror.end() || it->second != p) return false;
+            }
+            return true;
+        };
+
+        CHECK(g.tryMakeMove(Coord{0, 0}).ok);
+        CHECK(batches.size() == 1 && batches[0].seq == seq0 + 1 && batches[0].cells.size() == 1);
+        CHECK(batches[0].cells[0].player == Player::X && batches[0].cells[0].previous == Player::None);
+        CHECK(!g.tryMakeMove(Coord{0, 0}).ok); // отказ ничего не публикует
+        CHECK(batches.size() == 1);
+
+        // Пачка ходов — одна пачка изменений, линия меняет статистику.
+        const std::vector<Coord> line{Coord{5, 5}, Coord{1, 0}, Coord{5, 6}, Coord{2, 0}};
+        CHECK(g.playMoves(line) == 4);
+        CHECK(batches.size() == 2 && batches[1].seq == seq0 + 2 && batches[1].cells.size() == 4 && batches[1].statsChanged);
+        CHECK(mirrored() && g.changeSeq() == seq0 + 2);
+
+        CHECK(g.undo());
+        CHECK(batches.back().cells.size() == 1 && !batches.back().cells[0].set());
+        CHECK(batches.back().cells[0].previous == Player::X && batches.back().statsChanged); // снята тройка X
+
+        // Перемотка к началу и обратно: по одной пачке, зеркало совпадает с доской.
+        CHECK(g.seek(0));
+        CHECK(batches.back().cells.size() == 4 && mirror.empty());
+        CHECK(!g.seek(0));
+        CHECK(g.seek(100) && g.moveCount() == 5 && mirrored());
+        for (std::size_t i = 0; i < batches.size(); ++i) CHECK(batches[i].seq == seq0 + i + 1);
+
+        // Копия не уносит подписчиков; присваивание оставляет их и шлёт сброс с камнями новой позиции.
+        const std::size_t before = batches.size();
+        GameState copy(g);
+        CHECK(copy.undo());
+        CHECK(batches.size() == before);
+        g = copy;
+        CHECK(batches.size() == before + 1 && batches.back().reset && batches.back().cells.size() == 4);
+        CHECK(batches.back().cells[0].set() && batches.back().cells[0].previous == Player::None);
+        CHECK(mirrored() && g.moveCount() == 4);
+
+        g.newGame(rules, GameState::createBoard(rules));
+        CHECK(batches.back().reset && batches.back().seq == seq0 + before + 2 && batches.back().cells.empty());
+        CHECK(mirrored() && mirror.empty());
+
+        g.unsubscribe(id);
+        CHECK(g.tryMakeMove(Coord{0, 0}).ok);
+        CHECK(batches.size() == before + 2 && g.changeSeq() == seq0 + before + 3);
+    }
+
     std::cout << "All tests passed.\n";
     return 0;
 }
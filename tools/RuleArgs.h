@@ -0,0 +1,137 @@
+#ifndef TIKTAKTOE_TOOLS_RULEARGS_H
+#define TIKTAKTOE_TOOLS_RULEARGS_H
+#pragma once
+
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <engine/RuleSet.h>
+
+// Command-line parsing shared by the offline tools. Rule flags mirror the GUI (--width, --N, --classic, ...),
+// so a file built with the same flags has the same rules fingerprint as the game it serves.
+namespace tools {
+
+    class ArgList {
+    public:
+        ArgList(int argc, char** argv) {
+            for (int i = 1; i < argc; ++i) args_.emplace_back(argv[i]);
+            used_.assign(args_.size(), false);
+        }
+
+        bool flag(std::string_view name) {
+            for (std::size_t i = 0; i < args_.size(); ++i) {
+                if (args_[i] == name) {
+                    used_[i] = true;
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool value(std::string_view name, std::string& out) {
+            for (std::size_t i = 0; i + 1 < args_.size(); ++i) {
+                if (args_[i] == name) {
+                    used_[i] = used_[i + 1] = true;
+                    out = args_[i + 1];
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        template <class T>
+        bool number(std::string_view name, T& out) {
+            std::string v;
+            if (!value(name, v)) return false;
+            out = static_cast<T>(std::strtoll(v.c_str(), nullptr, 10));
+            return true;
+        }
+
+        // Arguments that no flag()/value() call consumed.
+        std::vector<std::string> unused() const {
+            std::vector<std::string> out;
+            for (std::size_t i = 0; i < args_.size(); ++i) {
+                if (!used_[i]) out.push_back(args_[i]);
+            }
+            return out;
+        }
+
+    private:
+        std::vector<std::string> args_;
+        std::vector<bool> used_;
+    };
+
+    inline void applyBoolPair(ArgList& args, std::string_view on, std::string_view off, bool& value) {
+        if (args.flag(on)) value = true;
+        if (args.flag(off)) value = false;
+    }
+
+    // Same defaults as the GUI (AppConfig::fromParser), overridden by flags.
+    inline engine::RuleSet parseRules(ArgList& args, std::vector<std::string>& errors) {
+        engine::RuleSet r;
+        r.topology = engine::BoardTopology::Finite;
+        r.width = 10;
+        r.height = 10;
+        r.N = 5;
+        r.classicWin = false;
+        r.maximizeLines = true;
+        r.lineMode = engine::LineLengthMode::AtLeastN;
+        r.countSubsegments = false;
+        r.weightsEnabled = false;
+        r.weightFunction = engine::CellValueFunction::constantFunc(1);
+        r.targetScore = 0;
+        r.maxMoves = 0;
+        r.moveCostsEnabled = false;
+        r.costFunction = engine::CellValueFunction::constantFunc(0);
+        r.costMode = engine::CostMode::CostFromBudget;
+        r.initialBudget = 0;
+
+        std::string s;
+        if (args.value("--topology", s)) {
+            if (s == "finite") r.topology = engine::BoardTopology::Finite;
+            else if (s == "infinite") r.topology = engine::BoardTopology::Infinite;
+            else errors.push_back("--topology must be finite|infinite");
+        }
+
+        args.number("--width", r.width);
+        args.number("--height", r.height);
+        args.number("--N", r.N);
+
+        applyBoolPair(args, "--classic", "--no-classic", r.classicWin);
+        applyBoolPair(args, "--maximize-lines", "--no-maximize-lines", r.maximizeLines);
+        applyBoolPair(args, "--weights", "--no-weights", r.weightsEnabled);
+        applyBoolPair(args, "--move-costs", "--no-move-costs", r.moveCostsEnabled);
+        applyBoolPair(args, "--count-subsegments", "--no-count-subsegments", r.countSubsegments);
+
+        if (args.value("--line-mode", s)) {
+            if (s == "exact") r.lineMode = engine::LineLengthMode::ExactN;
+            else if (s == "atleast") r.lineMode = engine::LineLengthMode::AtLeastN;
+            else errors.push_back("--line-mode must be exact|atleast");
+        }
+
+        args.number("--target-score", r.targetScore);
+        args.number("--max-moves", r.maxMoves);
+
+        if (args.value("--weight-type", s)) {
+            using T = engine::CellValueFunction::Type;
+            if (s == "constant") r.weightFunction.type = T::Constant;
+            else if (s == "manhattan") r.weightFunction.type = T::Manhattan;
+            else if (s == "chebyshev") r.weightFunction.type = T::Chebyshev;
+            else if (s == "radial2") r.weightFunction.type = T::RadialSquared;
+            else errors.push_back("--weight-type must be constant|manhattan|chebyshev|radial2");
+        }
+        args.number("--weight-constant", r.weightFunction.constant);
+        args.number("--weight-scale", r.weightFunction.scale);
+        args.number("--weight-offset", r.weightFunction.offset);
+        args.number("--weight-origin-x", r.weightFunction.originX);
+        args.number("--weight-origin-y", r.weightFunction.originY);
+
+        for (const auto& w : r.validateAndFix()) errors.push_back(w);
+        return r;
+    }
+
+}
+
+#endif
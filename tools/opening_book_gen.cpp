@@ -0,0 +1,158 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <engine/AI.h>
+#include <engine/OpeningBook.h>
+
+#include "RuleArgs.h"
+
+namespace {
+
+using Line = std::vector<engine::Coord>;
+
+engine::GameState replay(const engine::RuleSet& rules, const Line& moves, int radius) {
+    engine::GameState state(rules, engine::GameState::createBoard(rules));
+    state.setFrontierRadius(radius);
+    for (const engine::Coord& c : moves) state.tryMakeMove(c);
+    return state;
+}
+
+// Runs fn(i) for i in [0, n) on `threads` threads.
+template <class Fn>
+void parallelFor(std::size_t n, unsigned threads, Fn fn) {
+    std::atomic<std::size_t> next{0};
+    std::vector<std::thread> pool;
+    pool.reserve(threads);
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            for (std::size_t i = next.fetch_add(1); i < n; i = next.fetch_add(1)) fn(i);
+        });
+    }
+    for (auto& th : pool) th.join();
+}
+
+}
+
+// Offline book builder: opening_book_gen --out file.book [--threads T] [--games G] [--plies P] [--radius R]
+// [--move-ms MS] <rule flags as for the GUI>
+//
+// 1) G self-play games with differently seeded SimpleAI collect the positions of the first P plies;
+// 2) every distinct position (up to symmetry) gets a move from SimpleAI with a wide search and MS per move.
+int main(int argc, char** argv) {
+    tools::ArgList args(argc, argv);
+
+    if (args.flag("--help") || argc < 2) {
+        std::cout << "usage: opening_book_gen --out FILE [--threads T] [--games G] [--plies P] [--radius R]\n"
+                     "       [--move-ms MS] <rule flags as for tablebase_gen>\n";
+        return argc < 2 ? 1 : 0;
+    }
+
+    std::string out;
+    unsigned threads = std::thread::hardware_concurrency();
+    int games = 200;
+    int plies = 8;
+    int radius = 2;
+    int moveMs = 2000;
+    args.value("--out", out);
+    args.number("--threads", threads);
+    args.number("--games", games);
+    args.number("--plies", plies);
+    args.number("--radius", radius);
+    args.number("--move-ms", moveMs);
+    if (threads == 0) threads = 1;
+
+    std::vector<std::string> notes;
+    const engine::RuleSet rules = tools::parseRules(args, notes);
+    for (const auto& n : notes) std::cerr << "warning: " << n << "\n";
+
+    const auto unused = args.unused();
+    if (!unused.empty()) {
+        std::cerr << "unknown argument: " << unused.front() << "\n";
+        return 1;
+    }
+    if (out.empty()) {
+        std::cerr << "--out is required\n";
+        return 1;
+    }
+    if (games <= 0 || plies <= 0) {
+        std::cerr << "--games and --plies must be positive\n";
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    // Позиции первых plies ходов: канонический ключ -> одна из ведущих к ней партий.
+    std::unordered_map<std::uint64_t, Line> positions;
+    std::mutex positionsMutex;
+
+    parallelFor(static_cast<std::size_t>(games), threads, [&](std::size_t g) {
+        engine::SimpleAI::Settings s;
+        s.candidateRadius = radius;
+        s.seed = static_cast<unsigned>(g) + 1;
+        engine::SimpleAI ai(s);
+
+        engine::GameState state = replay(rules, {}, radius);
+        Line moves;
+        std::vector<std::pair<std::uint64_t, Line>> seen;
+        while (!state.isGameOver() && state.moveCount() < plies) {
+            seen.emplace_back(engine::OpeningBook::positionKey(state), moves);
+            const auto mv = ai.chooseMove(state, state.currentPlayer());
+            if (!mv || !state.tryMakeMove(*mv).ok) break;
+            moves.push_back(*mv);
+        }
+
+        std::lock_guard<std::mutex> lock(positionsMutex);
+        for (auto& [key, line] : seen) positions.try_emplace(key, std::move(line));
+    });
+
+    std::vector<Line> lines;
+    lines.reserve(positions.size());
+    for (auto& [key, line] : positions) lines.push_back(std::move(line));
+
+    std::cout << games << " games, " << lines.size() << " distinct positions\n";
+
+    std::vector<engine::OpeningBook::Entry> entries(lines.size());
+    std::vector<char> found(lines.size(), 0);
+    std::atomic<std::size_t> done{0};
+
+    parallelFor(lines.size(), threads, [&](std::size_t i) {
+        engine::SimpleAI::Settings s;
+        s.candidateRadius = radius;
+        s.maxTopMoves = 120;
+        s.maxOpponentReplies = 120;
+        engine::SimpleAI ai(s);
+
+        const engine::GameState state = replay(rules, lines[i], radius);
+        const auto mv = ai.chooseMove(state, state.currentPlayer(),
+                                      engine::SearchLimits::within(std::chrono::milliseconds(moveMs)));
+        if (mv) {
+            entries[i] = engine::OpeningBook::makeEntry(state, *mv);
+            found[i] = 1;
+        }
+        const std::size_t n = done.fetch_add(1) + 1;
+        if (n % 100 == 0) std::cerr << n << "/" << lines.size() << "\n";
+    });
+
+    std::vector<engine::OpeningBook::Entry> book;
+    book.reserve(entries.size());
+    for (std::size_t i = 0; i < entries.size(); ++i) {
+        if (found[i]) book.push_back(entries[i]);
+    }
+
+    std::string error;
+    if (!engine::OpeningBook::write(rules, book, plies - 1, out, &error)) {
+        std::cerr << "error: " << error << "\n";
+        return 1;
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << out << ": " << book.size() << " entries, fingerprint " << std::hex << rules.fingerprint() << std::dec
+              << ", " << secs << " s\n";
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <engine/Tablebase.h>
+
+#include "RuleArgs.h"
+
+// Offline retrograde generator: tablebase_gen --out file.tb [--threads T] <rule flags as for the GUI>
+int main(int argc, char** argv) {
+    tools::ArgList args(argc, argv);
+
+    if (args.flag("--help") || argc < 2) {
+        std::cout << "usage: tablebase_gen --out FILE [--threads T] [--width W --height H --N N\n"
+                     "       --classic|--no-classic --maximize-lines|--no-maximize-lines --weights|--no-weights\n"
+                     "       --line-mode exact|atleast --count-subsegments --target-score S --max-moves M\n"
+                     "       --weight-type constant|manhattan|chebyshev|radial2 --weight-constant C --weight-scale K\n"
+                     "       --weight-offset B --weight-origin-x X --weight-origin-y Y]\n";
+        return argc < 2 ? 1 : 0;
+    }
+
+    std::string out;
+    unsigned threads = std::thread::hardware_concurrency();
+    args.value("--out", out);
+    args.number("--threads", threads);
+
+    std::vector<std::string> notes;
+    const engine::RuleSet rules = tools::parseRules(args, notes);
+    for (const auto& n : notes) std::cerr << "warning: " << n << "\n";
+
+    const auto unused = args.unused();
+    if (!unused.empty()) {
+        std::cerr << "unknown argument: " << unused.front() << "\n";
+        return 1;
+    }
+    if (out.empty()) {
+        std::cerr << "--out is required\n";
+        return 1;
+    }
+    if (!engine::Tablebase::supports(rules)) {
+        std::cerr << "unsupported rules: need a finite board with at most "
+                  << engine::Tablebase::kMaxCells << " cells and no move costs\n";
+        return 1;
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::string error;
+    if (!engine::Tablebase::generate(rules, out, threads, &error)) {
+        std::cerr << "error: " << error << "\n";
+        return 1;
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    std::cout << out << ": " << rules.width << "x" << rules.height << " N=" << rules.N
+              << ", fingerprint " << std::hex << rules.fingerprint() << std::dec
+              << ", " << secs << " s\n";
+    return 0;
+}